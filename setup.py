@@ -6,18 +6,30 @@ extension = Extension(
     sources=[
         'src/tokenizers.c',
         'src/binary.c',
+        'src/bloom.c',
         'src/category.c',
+        'src/codec.c',
+        'src/dedup.c',
+        'src/embed.c',
+        'src/frozen.c',
+        'src/histogram.c',
+        'src/logits.c',
+        'src/strsort.c',
+        'src/scratch.c',
+        'src/sketch.c',
         'src/timestamp.c'
     ],
     include_dirs=['src', numpy.get_include()],
     extra_compile_args=[
-        '-O0',
+        '-O3',
         '-Wall',
         '-Werror=incompatible-pointer-types',
         '-Werror=implicit-function-declaration',
         '-fno-strict-aliasing',
-        '-fPIC'  # Position Independent Code
+        '-fPIC',  # Position Independent Code
+        '-pthread'
     ],
+    extra_link_args=['-pthread'],
 )
 
 setup(
@@ -1,6 +1,24 @@
 #include "binary.h"
+#include "hash.h"
 #include <math.h>
 #include <float.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define BINARY_PARALLEL_MIN (1 << 16)
+#define BINARY_MAX_THREADS 16
+#define BINARY_PROFILE_BLOCK 256
+
+static size_t fit_threads(size_t n) {
+    if (n < BINARY_PARALLEL_MIN) return 1;
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    size_t threads = cpus > 0 ? (size_t)cpus : 1;
+    if (threads > BINARY_MAX_THREADS) threads = BINARY_MAX_THREADS;
+    while (threads > 1 && n / threads < BINARY_PARALLEL_MIN / 4) threads--;
+    return threads;
+}
 
 void binary_init(BinaryTokenizer* t, int num_bits, int offset) {
     t->num_bits = num_bits;
@@ -8,9 +26,12 @@ void binary_init(BinaryTokenizer* t, int num_bits, int offset) {
     t->max_val = NAN;
     t->fitted = false;
     t->offset = offset;
+    t->groups = (BinaryGroupTable){NULL, 0, 0};
+    t->profiled = false;
 }
 
 void binary_fit(BinaryTokenizer* t, const double* values, size_t n) {
+    t->profiled = false;
     if (n == 0) {
         t->fitted = false;
         return;
@@ -29,13 +50,161 @@ void binary_fit(BinaryTokenizer* t, const double* values, size_t n) {
     t->fitted = true;
 }
 
-void binary_encode(const BinaryTokenizer* t, double value, int* indices, int* count) {
+void binary_fit_update(BinaryTokenizer* t, const double* values, size_t n) {
+    if (!t->fitted) {
+        binary_fit(t, values, n);
+        return;
+    }
+    t->profiled = false;
+    for (size_t i = 0; i < n; i++) {
+        if (values[i] < t->min_val) t->min_val = values[i];
+        if (values[i] > t->max_val) t->max_val = values[i];
+    }
+}
+
+// --- Profiling ---
+
+static void profile_init(BinaryProfile* p) {
+    memset(p, 0, sizeof(*p));
+    p->min_val = DBL_MAX;
+    p->max_val = -DBL_MAX;
+}
+
+static inline int profile_bucket(double v) {
+    uint64_t bits;
+    memcpy(&bits, &v, 8);
+    int k = (int)((bits >> 52) & 0x7ff) - 1023 - BINARY_PROFILE_MIN_EXP;
+    if (k < 0) k = 0;
+    if (k > BINARY_PROFILE_BUCKETS / 2 - 1) k = BINARY_PROFILE_BUCKETS / 2 - 1;
+    return (bits >> 63) ? BINARY_PROFILE_BUCKETS / 2 - 1 - k : BINARY_PROFILE_BUCKETS / 2 + k;
+}
+
+// Chan et al. parallel combination of count / mean / m2
+static inline void merge_moments(BinaryProfile* p, uint64_t count, double mean, double m2) {
+    if (count == 0) return;
+    uint64_t total = p->count + count;
+    double delta = mean - p->mean;
+    p->mean += delta * (double)count / (double)total;
+    p->m2 += m2 + delta * delta * (double)p->count * (double)count / (double)total;
+    p->count = total;
+}
+
+// Moments are taken per block with two branch-free (vectorizable) passes over
+// data still in L1, and blocks are combined with the parallel formula
+static void profile_range(BinaryProfile* p, const double* values, size_t n) {
+    for (size_t start = 0; start < n; start += BINARY_PROFILE_BLOCK) {
+        size_t len = n - start < BINARY_PROFILE_BLOCK ? n - start : BINARY_PROFILE_BLOCK;
+        const double* v = values + start;
+        uint64_t count = 0, zeros = 0;
+        double sum = 0.0, lo = p->min_val, hi = p->max_val;
+        for (size_t i = 0; i < len; i++) {
+            bool ok = v[i] == v[i];
+            count += ok;
+            zeros += v[i] == 0.0;
+            sum += ok ? v[i] : 0.0;
+            lo = v[i] < lo ? v[i] : lo;
+            hi = v[i] > hi ? v[i] : hi;
+        }
+        double mean = count ? sum / (double)count : 0.0;
+        double m2 = 0.0;
+        for (size_t i = 0; i < len; i++) {
+            double d = v[i] == v[i] ? v[i] - mean : 0.0;
+            m2 += d * d;
+        }
+        for (size_t i = 0; i < len; i++) {
+            if (v[i] == v[i] && v[i] != 0.0) p->histogram[profile_bucket(v[i])]++;
+        }
+        merge_moments(p, count, mean, m2);
+        p->nan_count += len - count;
+        p->zero_count += zeros;
+        p->min_val = lo;
+        p->max_val = hi;
+    }
+}
+
+typedef struct {
+    const double* values;
+    size_t begin;
+    size_t end;
+    BinaryProfile profile;
+} ProfileTask;
+
+static void* profile_worker(void* arg) {
+    ProfileTask* task = arg;
+    profile_init(&task->profile);
+    profile_range(&task->profile, task->values + task->begin, task->end - task->begin);
+    return NULL;
+}
+
+void binary_profile_merge(BinaryProfile* p, const BinaryProfile* other) {
+    merge_moments(p, other->count, other->mean, other->m2);
+    p->nan_count += other->nan_count;
+    p->zero_count += other->zero_count;
+    if (other->min_val < p->min_val) p->min_val = other->min_val;
+    if (other->max_val > p->max_val) p->max_val = other->max_val;
+    for (int b = 0; b < BINARY_PROFILE_BUCKETS; b++) p->histogram[b] += other->histogram[b];
+}
+
+void binary_profile(const double* values, size_t n, BinaryProfile* p) {
+    size_t threads = fit_threads(n);
+    ProfileTask tasks[BINARY_MAX_THREADS];
+    pthread_t handles[BINARY_MAX_THREADS];
+    bool started[BINARY_MAX_THREADS];
+    for (size_t i = 0; i < threads; i++) {
+        tasks[i].values = values;
+        tasks[i].begin = n * i / threads;
+        tasks[i].end = n * (i + 1) / threads;
+    }
+    for (size_t i = 1; i < threads; i++) {
+        started[i] = pthread_create(&handles[i], NULL, profile_worker, &tasks[i]) == 0;
+        if (!started[i]) profile_worker(&tasks[i]);
+    }
+    profile_worker(&tasks[0]);
+    for (size_t i = 1; i < threads; i++) {
+        if (started[i]) pthread_join(handles[i], NULL);
+    }
+    *p = tasks[0].profile;
+    for (size_t i = 1; i < threads; i++) binary_profile_merge(p, &tasks[i].profile);
+}
+
+void binary_fit_profiled(BinaryTokenizer* t, const double* values, size_t n) {
+    binary_profile(values, n, &t->profile);
+    t->profiled = true;
+    t->min_val = t->profile.min_val;
+    t->max_val = t->profile.max_val;
+    t->fitted = n > 0;
+}
+
+void binary_fit_update_profiled(BinaryTokenizer* t, const double* values, size_t n) {
+    if (!t->fitted) {
+        binary_fit_profiled(t, values, n);
+        return;
+    }
+    BinaryProfile chunk;
+    binary_profile(values, n, &chunk);
+    if (chunk.min_val < t->min_val) t->min_val = chunk.min_val;
+    if (chunk.max_val > t->max_val) t->max_val = chunk.max_val;
+    if (t->profiled) binary_profile_merge(&t->profile, &chunk);
+}
+
+// The missing token, for NaN and rows marked missing
+static inline void encode_missing(const BinaryTokenizer* t, int* indices, int* count) {
+    indices[0] = t->offset;
+    *count = 1;
+}
+
+// Bisect [min_val, max_val] num_bits times, emitting a token for every upper half
+static inline void encode_range(const BinaryTokenizer* t, double min_val, double max_val,
+                                double value, int* indices, int* count) {
     *count = 0;
-    if (!t->fitted || isnan(value)) return;
-    if (!((value >= t->min_val)&&(value <= t->max_val))) return;
+    if (isnan(value)) {
+        encode_missing(t, indices, count);
+        return;
+    }
+    if (!((value >= min_val)&&(value <= max_val))) return;
     
-    double center = (t->min_val + t->max_val) / 2.0;
-    double width = (t->max_val - t->min_val) / 2.0;
+    double center = (min_val + max_val) / 2.0;
+    double width = (max_val - min_val) / 2.0;
 
     // sentinel value for below minimum
     for (int b = 0; b < t->num_bits; b++) {
@@ -49,13 +218,103 @@ void binary_encode(const BinaryTokenizer* t, double value, int* indices, int* co
     }
 }
 
-double binary_decode(const BinaryTokenizer* t, const int* indices, int count) {
-    if (!t->fitted || count == 0) return NAN;
+void binary_encode(const BinaryTokenizer* t, double value, int* indices, int* count) {
+    *count = 0;
+    if (!t->fitted && !isnan(value)) return;
+    encode_range(t, t->min_val, t->max_val, value, indices, count);
+}
+
+void binary_embed_batch(const BinaryTokenizer* t, const double* values, size_t n,
+                        const float* table, size_t dim, float* out, EmbedPooling pooling) {
+    memset(out, 0, n * dim * sizeof(float));
+    if (!t->fitted) return;
+    const double min_val = t->min_val;
+    const double max_val = t->max_val;
+    for (size_t i = 0; i < n; i++) {
+        double value = values[i];
+        if (isnan(value)) {
+            embed_tokens(table, (size_t)t->offset + t->num_bits + 1, dim, &t->offset, 1, out + i * dim, pooling);
+            continue;
+        }
+        if (!((value >= min_val) && (value <= max_val))) continue;
+
+        // The bisection of encode_range, adding each active token's row as it is found
+        float* row = out + i * dim;
+        double center = (min_val + max_val) / 2.0;
+        double width = (max_val - min_val) / 2.0;
+        int count = 0;
+        for (int b = 0; b < t->num_bits; b++) {
+            if (value > center) {
+                embed_add(row, table + (size_t)((b + 1) + t->offset) * dim, dim);
+                count++;
+                center += width / 2.0;
+            } else {
+                center -= width / 2.0;
+            }
+            width /= 2.0;
+        }
+        embed_finish(row, dim, count, pooling);
+    }
+}
+
+static bool encode_rows(const BinaryTokenizer* t, const double* values, size_t n,
+                        int* tokens, int* counts, DedupMode mode) {
+    size_t stride = (size_t)t->num_bits;
+    if (mode == DEDUP_AUTO) mode = dedup_doubles_worthwhile(values, n) ? DEDUP_ON : DEDUP_OFF;
+    if (mode == DEDUP_OFF) {
+        for (size_t i = 0; i < n; i++) binary_encode(t, values[i], tokens + i * stride, &counts[i]);
+        return true;
+    }
+
+    // Encode each distinct value into the row of its first occurrence, then copy
+    size_t* ids = malloc(2 * n * sizeof(size_t));
+    if (!ids) return false;
+    size_t* first = ids + n;
+    size_t groups = dedup_doubles(values, n, ids, first);
+    if (groups == 0 && n > 0) {
+        free(ids);
+        return false;
+    }
+    for (size_t g = 0; g < groups; g++) {
+        size_t row = first[g];
+        binary_encode(t, values[row], tokens + row * stride, &counts[row]);
+    }
+    for (size_t i = 0; i < n; i++) {
+        size_t row = first[ids[i]];
+        if (row == i) continue;
+        counts[i] = counts[row];
+        memcpy(tokens + i * stride, tokens + row * stride, counts[row] * sizeof(int));
+    }
+    free(ids);
+    return true;
+}
 
-    double center = (t->min_val + t->max_val) / 2.0;
-    double width = (t->max_val - t->min_val) / 2.0;
+bool binary_encode_batch(const BinaryTokenizer* t, const double* values, const uint8_t* validity, size_t n,
+                         int* tokens, int* counts, DedupMode mode) {
+    size_t stride = (size_t)t->num_bits;
+    size_t end;
+    for (size_t start = 0; start < n; start = end) {
+        bool valid;
+        end = validity_run(validity, n, start, &valid);
+        if (valid) {
+            if (!encode_rows(t, values + start, end - start, tokens + start * stride, counts + start, mode))
+                return false;
+        } else {
+            for (size_t i = start; i < end; i++) encode_missing(t, tokens + i * stride, &counts[i]);
+        }
+    }
+    return true;
+}
+
+static inline double decode_range(const BinaryTokenizer* t, double min_val, double max_val,
+                                  const int* indices, int count) {
+    double center = (min_val + max_val) / 2.0;
+    double width = (max_val - min_val) / 2.0;
     double value = center;
 
+    for (int i = 0; i < count; i++) {
+        if (indices[i] == t->offset) return NAN;    // missing
+    }
     for (int b = 0; b < t->num_bits; b++) {
         int active = 0;
         for (int i = 0; i < count; i++) {
@@ -66,4 +325,403 @@ double binary_decode(const BinaryTokenizer* t, const int* indices, int count) {
     }
 
     return value;
-}
\ No newline at end of file
+}
+
+double binary_decode(const BinaryTokenizer* t, const int* indices, int count) {
+    if (!t->fitted || count == 0) return NAN;
+    return decode_range(t, t->min_val, t->max_val, indices, count);
+}
+
+// --- Grouped ranges ---
+
+static inline size_t group_slot(int64_t key, size_t mask) {
+    return hash_mix((uint64_t)key) & mask;
+}
+
+static bool group_table_init(BinaryGroupTable* g, size_t capacity) {
+    size_t slots = 16;
+    while (slots < 2 * capacity) slots *= 2;
+    g->slots = calloc(slots, sizeof(BinaryGroup));
+    g->mask = slots - 1;
+    g->count = 0;
+    return g->slots != NULL;
+}
+
+static void group_table_free(BinaryGroupTable* g) {
+    free(g->slots);
+    *g = (BinaryGroupTable){NULL, 0, 0};
+}
+
+static BinaryGroup* group_table_find(const BinaryGroupTable* g, int64_t key) {
+    if (!g->slots) return NULL;
+    for (size_t s = group_slot(key, g->mask);; s = (s + 1) & g->mask) {
+        if (!g->slots[s].used) return NULL;
+        if (g->slots[s].key == key) return &g->slots[s];
+    }
+}
+
+// Copy every group of g into the empty table into
+static void group_table_rehash(const BinaryGroupTable* g, BinaryGroupTable* into) {
+    for (size_t i = 0; i <= g->mask; i++) {
+        if (!g->slots[i].used) continue;
+        size_t t = group_slot(g->slots[i].key, into->mask);
+        while (into->slots[t].used) t = (t + 1) & into->mask;
+        into->slots[t] = g->slots[i];
+    }
+    into->count = g->count;
+}
+
+// Widen the range of key to cover [min_val, max_val], adding the group if new
+static bool group_table_update(BinaryGroupTable* g, int64_t key, double min_val, double max_val) {
+    size_t s = group_slot(key, g->mask);
+    while (g->slots[s].used && g->slots[s].key != key) s = (s + 1) & g->mask;
+    BinaryGroup* group = &g->slots[s];
+    if (group->used) {
+        if (min_val < group->min_val) group->min_val = min_val;
+        if (max_val > group->max_val) group->max_val = max_val;
+        return true;
+    }
+    if (2 * (g->count + 1) > g->mask + 1) {
+        BinaryGroupTable grown;
+        if (!group_table_init(&grown, g->count + 1)) return false;
+        group_table_rehash(g, &grown);
+        group_table_free(g);
+        *g = grown;
+        return group_table_update(g, key, min_val, max_val);
+    }
+    *group = (BinaryGroup){key, min_val, max_val, true};
+    g->count++;
+    return true;
+}
+
+typedef struct {
+    const double* values;
+    const int64_t* groups;
+    size_t begin;
+    size_t end;
+    double min_val;
+    double max_val;
+    BinaryGroupTable table;
+    bool ok;
+} GroupFitTask;
+
+// Aggregate one chunk; consecutive rows of the same group are folded before the table
+static void* group_fit_worker(void* arg) {
+    GroupFitTask* task = arg;
+    task->min_val = DBL_MAX;
+    task->max_val = -DBL_MAX;
+    task->ok = group_table_init(&task->table, 64);
+    size_t i = task->begin;
+    while (task->ok && i < task->end) {
+        int64_t key = task->groups[i];
+        double lo = DBL_MAX, hi = -DBL_MAX;
+        for (; i < task->end && task->groups[i] == key; i++) {
+            double v = task->values[i];
+            if (v < lo) lo = v;
+            if (v > hi) hi = v;
+        }
+        if (lo > hi) continue;  // only NaNs
+        if (lo < task->min_val) task->min_val = lo;
+        if (hi > task->max_val) task->max_val = hi;
+        task->ok = group_table_update(&task->table, key, lo, hi);
+    }
+    return NULL;
+}
+
+bool binary_fit_grouped(BinaryTokenizer* t, const double* values, const int64_t* groups, size_t n) {
+    size_t threads = fit_threads(n);
+    GroupFitTask tasks[BINARY_MAX_THREADS];
+    pthread_t handles[BINARY_MAX_THREADS];
+    bool started[BINARY_MAX_THREADS];
+    for (size_t i = 0; i < threads; i++) {
+        tasks[i] = (GroupFitTask){values, groups, n * i / threads, n * (i + 1) / threads};
+    }
+    for (size_t i = 1; i < threads; i++) {
+        started[i] = pthread_create(&handles[i], NULL, group_fit_worker, &tasks[i]) == 0;
+        if (!started[i]) group_fit_worker(&tasks[i]);
+    }
+    group_fit_worker(&tasks[0]);
+    for (size_t i = 1; i < threads; i++) {
+        if (started[i]) pthread_join(handles[i], NULL);
+    }
+
+    // Merge the per-thread tables into the first
+    bool ok = true;
+    for (size_t i = 0; i < threads; i++) ok = ok && tasks[i].ok;
+    for (size_t i = 1; ok && i < threads; i++) {
+        BinaryGroupTable* local = &tasks[i].table;
+        for (size_t s = 0; ok && s <= local->mask; s++) {
+            BinaryGroup* g = &local->slots[s];
+            if (g->used) ok = group_table_update(&tasks[0].table, g->key, g->min_val, g->max_val);
+        }
+        if (tasks[i].min_val < tasks[0].min_val) tasks[0].min_val = tasks[i].min_val;
+        if (tasks[i].max_val > tasks[0].max_val) tasks[0].max_val = tasks[i].max_val;
+    }
+    for (size_t i = 1; i < threads; i++) group_table_free(&tasks[i].table);
+    if (!ok) {
+        group_table_free(&tasks[0].table);
+        return false;
+    }
+
+    binary_free(t);
+    t->groups = tasks[0].table;
+    t->profiled = false;
+    t->min_val = tasks[0].min_val;
+    t->max_val = tasks[0].max_val;
+    t->fitted = n > 0;
+    // Worker tables start large and merging may have grown them further
+    binary_shrink_to_fit(t);
+    return true;
+}
+
+bool binary_add_group(BinaryTokenizer* t, int64_t group, double min_val, double max_val) {
+    if (!t->groups.slots && !group_table_init(&t->groups, 16)) return false;
+    return group_table_update(&t->groups, group, min_val, max_val);
+}
+
+const BinaryGroup* binary_find_group(const BinaryTokenizer* t, int64_t group) {
+    return group_table_find(&t->groups, group);
+}
+
+size_t binary_memory_usage(const BinaryTokenizer* t) {
+    return t->groups.slots ? (t->groups.mask + 1) * sizeof(BinaryGroup) : 0;
+}
+
+bool binary_shrink_to_fit(BinaryTokenizer* t) {
+    BinaryGroupTable* g = &t->groups;
+    if (!g->slots) return true;
+    BinaryGroupTable compact;
+    if (!group_table_init(&compact, g->count)) return false;
+    if (compact.mask >= g->mask) {
+        group_table_free(&compact);
+        return true;
+    }
+    group_table_rehash(g, &compact);
+    group_table_free(g);
+    *g = compact;
+    return true;
+}
+
+void binary_free(BinaryTokenizer* t) {
+    group_table_free(&t->groups);
+}
+
+void binary_encode_grouped_batch(const BinaryTokenizer* t, const double* values, const int64_t* groups,
+                                 const uint8_t* validity, size_t n, int* tokens, int* counts, bool fallback) {
+    size_t stride = (size_t)t->num_bits;
+    const BinaryGroup* group = NULL;
+    size_t end;
+    for (size_t start = 0; start < n; start = end) {
+        bool valid;
+        end = validity_run(validity, n, start, &valid);
+        if (!valid) {
+            for (size_t i = start; i < end; i++) encode_missing(t, tokens + i * stride, &counts[i]);
+            continue;
+        }
+        for (size_t i = start; i < end; i++) {
+            // Rows of one group tend to be adjacent; reuse the last lookup
+            if (!group || group->key != groups[i]) group = binary_find_group(t, groups[i]);
+            if (group) {
+                encode_range(t, group->min_val, group->max_val, values[i], tokens + i * stride, &counts[i]);
+            } else if (fallback || isnan(values[i])) {
+                binary_encode(t, values[i], tokens + i * stride, &counts[i]);
+            } else {
+                counts[i] = 0;
+            }
+        }
+    }
+}
+
+typedef double f64x4 __attribute__((vector_size(32)));
+typedef int64_t i64x4 __attribute__((vector_size(32)));
+typedef float f32x4 __attribute__((vector_size(16)));
+
+void binary_decode_probs(const BinaryTokenizer* t, const float* probs, size_t n, const int64_t* groups,
+                         bool fallback, double* mean, double* var, double* map) {
+    const size_t bits = (size_t)t->num_bits;
+    const BinaryGroup* group = NULL;
+    for (size_t i = 0; i < n; i++) {
+        double min_val = t->min_val, max_val = t->max_val;
+        bool ok = t->fitted;
+        if (groups) {
+            if (!group || group->key != groups[i]) group = binary_find_group(t, groups[i]);
+            if (group) {
+                min_val = group->min_val;
+                max_val = group->max_val;
+            } else {
+                ok = ok && fallback;
+            }
+        }
+        if (!ok) {
+            if (mean) mean[i] = NAN;
+            if (var) var[i] = NAN;
+            if (map) map[i] = NAN;
+            continue;
+        }
+
+        // Bit b moves the value by +-w * (max - min) around the center, w = 2^-(b+2).
+        // With p = P(bit b set) it adds w * (2p - 1) to the mean and w^2 * 4p(1 - p)
+        // to the variance; the most likely token set takes the sign of p - 1/2.
+        const float* p = probs + i * bits;
+        const f64x4 one = {1.0, 1.0, 1.0, 1.0};
+        const f64x4 half = {0.5, 0.5, 0.5, 0.5};
+        f64x4 w = {0.25, 0.125, 0.0625, 0.03125};
+        f64x4 s1 = {0.0, 0.0, 0.0, 0.0}, s2 = s1, s3 = s1;
+        size_t b = 0;
+        for (; b + 4 <= bits; b += 4) {
+            f32x4 pf;
+            memcpy(&pf, p + b, sizeof(pf));
+            f64x4 pb = __builtin_convertvector(pf, f64x4);
+            i64x4 set = pb > half;
+            s1 += w * (pb + pb - one);
+            s2 += w * w * (pb * (one - pb));
+            s3 += (f64x4)((set & (i64x4)w) | (~set & (i64x4)(-w)));
+            w *= 0.0625;
+        }
+        double e = s1[0] + s1[1] + s1[2] + s1[3];
+        double v = s2[0] + s2[1] + s2[2] + s2[3];
+        double m = s3[0] + s3[1] + s3[2] + s3[3];
+        for (; b < bits; b++) {
+            double wb = ldexp(1.0, -(int)b - 2);
+            double pb = p[b];
+            e += wb * (2.0 * pb - 1.0);
+            v += wb * wb * pb * (1.0 - pb);
+            m += pb > 0.5 ? wb : -wb;
+        }
+        double range = max_val - min_val;
+        double center = (min_val + max_val) / 2.0;
+        if (mean) mean[i] = center + range * e;
+        if (var) var[i] = 4.0 * range * range * v;
+        if (map) map[i] = center + range * m;
+    }
+}
+
+// Bin tokens: NaN, outside the range (or no range), then one per bin
+static inline int bin_token(const BinaryTokenizer* t, double value, int64_t bin) {
+    if (isnan(value)) return t->offset;
+    return bin < 0 ? t->offset + 1 : t->offset + 2 + (int)bin;
+}
+
+// The bisection of encode_range with token b + 1 as bit num_bits - 1 - b of the
+// bin index; -1 outside [min_val, max_val]
+static inline int64_t bin_range(int num_bits, double min_val, double max_val, double value) {
+    if (!((value >= min_val) && (value <= max_val))) return -1;
+    double center = (min_val + max_val) / 2.0;
+    double width = (max_val - min_val) / 2.0;
+    int64_t bin = 0;
+    for (int b = 0; b < num_bits; b++) {
+        bool up = value > center;
+        center += up ? width / 2.0 : -(width / 2.0);
+        bin = (bin << 1) | up;
+        width /= 2.0;
+    }
+    return bin;
+}
+
+// bin_range of four values at once; every step is the same IEEE operation as the
+// scalar one, so the bins agree exactly
+static inline void bin_range4(int num_bits, double min_val, double max_val, const double* values,
+                              int64_t* bins) {
+    f64x4 value;
+    memcpy(&value, values, sizeof(value));
+    const f64x4 lo = {min_val, min_val, min_val, min_val};
+    const f64x4 hi = {max_val, max_val, max_val, max_val};
+    const double c = (min_val + max_val) / 2.0;
+    f64x4 center = {c, c, c, c};
+    double width = (max_val - min_val) / 2.0;
+    i64x4 bin = {0, 0, 0, 0};
+    for (int b = 0; b < num_bits; b++) {
+        const double h = width / 2.0;
+        const f64x4 step = {h, h, h, h};
+        i64x4 up = value > center;
+        center += (f64x4)((up & (i64x4)step) | (~up & (i64x4)(-step)));
+        bin = (bin << 1) - up;
+        width /= 2.0;
+    }
+    i64x4 in = (value >= lo) & (value <= hi);
+    bin = (bin & in) | ~in;
+    memcpy(bins, &bin, sizeof(bin));
+}
+
+// binary_encode_bins of rows that are all present
+static void encode_bin_rows(const BinaryTokenizer* t, const double* values, const int64_t* groups, size_t n,
+                            bool fallback, int32_t* tokens) {
+    if (groups) {
+        const BinaryGroup* group = NULL;
+        for (size_t i = 0; i < n; i++) {
+            if (!group || group->key != groups[i]) group = binary_find_group(t, groups[i]);
+            int64_t bin = -1;
+            if (group) bin = bin_range(t->num_bits, group->min_val, group->max_val, values[i]);
+            else if (fallback && t->fitted) bin = bin_range(t->num_bits, t->min_val, t->max_val, values[i]);
+            tokens[i] = bin_token(t, values[i], bin);
+        }
+        return;
+    }
+
+    size_t i = 0;
+    if (t->fitted) {
+        for (; i + 4 <= n; i += 4) {
+            int64_t bins[4];
+            bin_range4(t->num_bits, t->min_val, t->max_val, values + i, bins);
+            for (int k = 0; k < 4; k++) tokens[i + k] = bin_token(t, values[i + k], bins[k]);
+        }
+    }
+    for (; i < n; i++) {
+        int64_t bin = t->fitted ? bin_range(t->num_bits, t->min_val, t->max_val, values[i]) : -1;
+        tokens[i] = bin_token(t, values[i], bin);
+    }
+}
+
+void binary_encode_bins(const BinaryTokenizer* t, const double* values, const int64_t* groups,
+                        const uint8_t* validity, size_t n, bool fallback, int32_t* tokens) {
+    size_t end;
+    for (size_t start = 0; start < n; start = end) {
+        bool valid;
+        end = validity_run(validity, n, start, &valid);
+        if (valid) {
+            encode_bin_rows(t, values + start, groups ? groups + start : NULL, end - start, fallback, tokens + start);
+        } else {
+            for (size_t i = start; i < end; i++) tokens[i] = t->offset;
+        }
+    }
+}
+
+void binary_decode_bins(const BinaryTokenizer* t, const int32_t* tokens, const int64_t* groups, size_t n,
+                        bool fallback, double* values) {
+    const int64_t num_bins = (int64_t)1 << t->num_bits;
+    const BinaryGroup* group = NULL;
+    for (size_t i = 0; i < n; i++) {
+        double min_val = t->min_val, max_val = t->max_val;
+        bool ok = t->fitted;
+        if (groups) {
+            if (!group || group->key != groups[i]) group = binary_find_group(t, groups[i]);
+            if (group) {
+                min_val = group->min_val;
+                max_val = group->max_val;
+            } else {
+                ok = ok && fallback;
+            }
+        }
+        int64_t bin = (int64_t)tokens[i] - (t->offset + 2);
+        if (!ok || bin < 0 || bin >= num_bins) {
+            values[i] = NAN;
+            continue;
+        }
+        // decode_range with the bin's bits as the active tokens
+        double center = (min_val + max_val) / 2.0;
+        double width = (max_val - min_val) / 2.0;
+        for (int b = t->num_bits - 1; b >= 0; b--) {
+            center += ((bin >> b) & 1) ? (width / 2.0) : (-width / 2.0);
+            width /= 2.0;
+        }
+        values[i] = center;
+    }
+}
+
+double binary_decode_grouped(const BinaryTokenizer* t, const int* indices, int count,
+                             int64_t group, bool fallback) {
+    if (!t->fitted || count == 0) return NAN;
+    const BinaryGroup* g = binary_find_group(t, group);
+    if (g) return decode_range(t, g->min_val, g->max_val, indices, count);
+    return fallback ? binary_decode(t, indices, count) : NAN;
+}
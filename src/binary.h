@@ -3,6 +3,42 @@
 
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
+#include "dedup.h"
+#include "embed.h"
+#include "validity.h"
+
+// Fitted range of one group
+typedef struct __attribute__((aligned(8))) {
+    int64_t key;
+    double min_val;
+    double max_val;
+    bool used;
+} BinaryGroup;
+
+// Open addressing table of group ranges, at most half full
+typedef struct __attribute__((aligned(8))) {
+    BinaryGroup* slots;
+    size_t mask;        // number of slots - 1
+    size_t count;
+} BinaryGroupTable;
+
+#define BINARY_PROFILE_BUCKETS 128    // 64 per sign, by binary exponent
+#define BINARY_PROFILE_MIN_EXP (-32)   // smaller magnitudes share the innermost buckets
+
+// Distribution summary gathered during fit
+typedef struct __attribute__((aligned(8))) {
+    uint64_t count;         // non-NaN values
+    uint64_t nan_count;
+    uint64_t zero_count;
+    double mean;
+    double m2;              // sum of squared deviations from the mean
+    double min_val;
+    double max_val;
+    // Bucket 64 + k holds positives with exponent MIN_EXP + k (clamped to 0..63),
+    // bucket 63 - k the negatives with that exponent; zeros are only counted
+    uint64_t histogram[BINARY_PROFILE_BUCKETS];
+} BinaryProfile;
 
 typedef struct __attribute__((aligned(8))) {
     int num_bits;
@@ -10,6 +46,9 @@ typedef struct __attribute__((aligned(8))) {
     double max_val;
     bool fitted;
     int offset;
+    BinaryGroupTable groups;    // per-group ranges (empty unless fitted grouped)
+    bool profiled;
+    BinaryProfile profile;      // valid if profiled
 } BinaryTokenizer;
 
 // Initialize tokenizer
@@ -18,10 +57,88 @@ void binary_init(BinaryTokenizer* t, int num_bits, int offset);
 // Fit to data (calculate min/max)
 void binary_fit(BinaryTokenizer* t, const double* values, size_t n);
 
-// Encode value into tokens
+// Extend the fitted range with more data (fits from scratch if not fitted)
+void binary_fit_update(BinaryTokenizer* t, const double* values, size_t n);
+
+// Fit and profile in one parallel pass over the data
+void binary_fit_profiled(BinaryTokenizer* t, const double* values, size_t n);
+
+// binary_fit_update that also folds the data into the profile
+void binary_fit_update_profiled(BinaryTokenizer* t, const double* values, size_t n);
+
+// Profile n values (moments, NaN/zero counts, range, log histogram) in parallel
+void binary_profile(const double* values, size_t n, BinaryProfile* p);
+
+// Combine the profile of other (disjoint) data into p
+void binary_profile_merge(BinaryProfile* p, const BinaryProfile* other);
+
+// Fit the global range and one range per group key in a parallel pass
+// (false on allocation failure)
+bool binary_fit_grouped(BinaryTokenizer* t, const double* values, const int64_t* groups, size_t n);
+
+// Add or widen one group range (false on allocation failure)
+bool binary_add_group(BinaryTokenizer* t, int64_t group, double min_val, double max_val);
+
+// Fitted range of a group (NULL if the group was not seen at fit)
+const BinaryGroup* binary_find_group(const BinaryTokenizer* t, int64_t group);
+
+// Heap bytes held by the tokenizer (the group ranges)
+size_t binary_memory_usage(const BinaryTokenizer* t);
+
+// Rehash the group ranges into the smallest table that holds them
+// (false on allocation failure; the tokenizer stays valid)
+bool binary_shrink_to_fit(BinaryTokenizer* t);
+
+// Free the group ranges
+void binary_free(BinaryTokenizer* t);
+
+// Encode value into tokens (NaN encodes to the missing token, offset)
 void binary_encode(const BinaryTokenizer* t, double value, int* indices, int* count);
 
-// Decode tokens into value
+// Encode n values into rows of num_bits tokens (counts[i] used in row i); rows
+// missing from the validity bitmap (optional) encode to the missing token
+// (false on allocation failure)
+bool binary_encode_batch(const BinaryTokenizer* t, const double* values, const uint8_t* validity, size_t n,
+                         int* tokens, int* counts, DedupMode mode);
+
+// Encode n values against their group's range; unseen groups use the global
+// range if fallback is set and encode to no tokens otherwise
+void binary_encode_grouped_batch(const BinaryTokenizer* t, const double* values, const int64_t* groups,
+                                 const uint8_t* validity, size_t n, int* tokens, int* counts, bool fallback);
+
+// Encode n values and pool the table rows of their tokens into rows of dim floats,
+// without materializing the tokens (NaN pools the missing token's row). The table
+// needs offset + num_bits + 1 rows.
+void binary_embed_batch(const BinaryTokenizer* t, const double* values, size_t n,
+                        const float* table, size_t dim, float* out, EmbedPooling pooling);
+
+#define BINARY_MAX_BIN_BITS 30    // bin tokens must fit an int32
+
+// Encode n values into one token each: offset for NaN and missing rows, offset + 1
+// for values outside the range (or without one), offset + 2 + bin otherwise. The
+// bin index holds the bisection bits, first bit most significant. groups and
+// validity are optional; groups select ranges as in binary_encode_grouped_batch.
+// num_bits <= BINARY_MAX_BIN_BITS.
+void binary_encode_bins(const BinaryTokenizer* t, const double* values, const int64_t* groups,
+                        const uint8_t* validity, size_t n, bool fallback, int32_t* tokens);
+
+// Decode bin tokens into the value decode_range reconstructs from the bin's token
+// set (NaN for the sentinels, invalid tokens and rows without a range)
+void binary_decode_bins(const BinaryTokenizer* t, const int32_t* tokens, const int64_t* groups, size_t n,
+                        bool fallback, double* values);
+
+// Decode tokens into value (NaN for no tokens or the missing token)
 double binary_decode(const BinaryTokenizer* t, const int* indices, int count);
 
+// Decode n rows of num_bits independent bit probabilities into the expected value
+// and, where the output is not NULL, its variance and the value of the most likely
+// token set. groups (optional) selects each row's range as in binary_decode_grouped;
+// rows without a range decode to NaN.
+void binary_decode_probs(const BinaryTokenizer* t, const float* probs, size_t n, const int64_t* groups,
+                         bool fallback, double* mean, double* var, double* map);
+
+// Decode tokens against a group's range (NaN for unseen groups without fallback)
+double binary_decode_grouped(const BinaryTokenizer* t, const int* indices, int count,
+                             int64_t group, bool fallback);
+
 #endif
\ No newline at end of file
@@ -0,0 +1,51 @@
+#include "bloom.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+void bloom_init(BloomFilter* b) {
+    b->blocks = NULL;
+    b->num_blocks = 0;
+    b->k = 0;
+}
+
+bool bloom_build(BloomFilter* b, size_t n, double fpr) {
+    bloom_free(b);
+    if (n == 0 || !(fpr > 0.0 && fpr < 1.0)) return false;
+
+    // Optimal bits per key, padded for the load skew of blocked filters
+    // (which matters more the lower the target rate)
+    double bits_per_key = (1.0 + 0.06 * -log2(fpr)) * -log(fpr) / (M_LN2 * M_LN2);
+    int k = (int)lround(-log2(fpr));
+    if (k < 1) k = 1;
+    if (k > 16) k = 16;
+    size_t num_blocks = (size_t)ceil(bits_per_key * (double)n / 512.0);
+    if (num_blocks == 0) num_blocks = 1;
+    if (num_blocks > UINT32_MAX) return false;
+
+    void* blocks = NULL;
+    size_t size = num_blocks * BLOOM_BLOCK_WORDS * sizeof(uint64_t);
+    if (posix_memalign(&blocks, 64, size) != 0) return false;
+    memset(blocks, 0, size);
+
+    b->blocks = blocks;
+    b->num_blocks = num_blocks;
+    b->k = k;
+    return true;
+}
+
+void bloom_add(BloomFilter* b, uint64_t hash) {
+    uint64_t* block = b->blocks +
+        (size_t)(((hash >> 32) * (uint64_t)b->num_blocks) >> 32) * BLOOM_BLOCK_WORDS;
+    uint32_t h1 = (uint32_t)hash;
+    uint32_t h2 = (uint32_t)(hash >> 23) | 1;
+    for (int i = 0; i < b->k; i++) {
+        uint32_t bit = (h1 + (uint32_t)i * h2) & 511;
+        block[bit >> 6] |= 1ULL << (bit & 63);
+    }
+}
+
+void bloom_free(BloomFilter* b) {
+    free(b->blocks);
+    bloom_init(b);
+}
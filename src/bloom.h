@@ -0,0 +1,42 @@
+#ifndef BLOOM_FILTER_H
+#define BLOOM_FILTER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define BLOOM_BLOCK_WORDS 8  // 512 bits, one cache line per key
+
+typedef struct __attribute__((aligned(8))) {
+    uint64_t* blocks;   // num_blocks * BLOOM_BLOCK_WORDS words, 64-byte aligned
+    size_t num_blocks;
+    int k;              // bits set per key
+} BloomFilter;
+
+// Initialize an empty filter
+void bloom_init(BloomFilter* b);
+
+// Size the filter for n keys at the target false positive rate (false on allocation failure)
+bool bloom_build(BloomFilter* b, size_t n, double fpr);
+
+// Insert a key by its 64-bit hash
+void bloom_add(BloomFilter* b, uint64_t hash);
+
+// Free resources
+void bloom_free(BloomFilter* b);
+
+// False means the key was never added; true may be a false positive
+static inline bool bloom_maybe_contains(const BloomFilter* b, uint64_t hash) {
+    const uint64_t* block = b->blocks +
+        (size_t)(((hash >> 32) * (uint64_t)b->num_blocks) >> 32) * BLOOM_BLOCK_WORDS;
+    uint32_t h1 = (uint32_t)hash;
+    uint32_t h2 = (uint32_t)(hash >> 23) | 1;
+    uint64_t missing = 0;
+    for (int i = 0; i < b->k; i++) {
+        uint32_t bit = (h1 + (uint32_t)i * h2) & 511;
+        missing |= ~block[bit >> 6] & (1ULL << (bit & 63));
+    }
+    return missing == 0;
+}
+
+#endif
@@ -1,17 +1,50 @@
 #include "category.h"
+#include "hash.h"
+#include "logits.h"
+#include "strsort.h"
 #include <string.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <stdint.h>
+#include <math.h>
 
-static int compare_strings(const void* a, const void* b) {
-    return strcmp(*(const char**)a, *(const char**)b);
-}
+#define PARTIAL_MAGIC "ZFCP"
+#define PARTIAL_VERSION 1
 
 void category_init(CategoryTokenizer* t, int offset) {
     t->categories = NULL;
     t->num_categories = 0;
+    t->sorted_ids = NULL;
+    t->arena = NULL;
+    t->arena_size = 0;
+    t->arena_capacity = 0;
     t->fitted = false;
     t->offset = offset;
+    t->bloom_fpr = 0.0;
+    bloom_init(&t->bloom);
+    t->order = CATEGORY_ORDER_SORTED;
+    t->small_keys = NULL;
+    t->small_padded = 0;
+    t->eytzinger_prefixes = NULL;
+    t->eytzinger_ids = NULL;
+}
+
+static void category_build_bloom(CategoryTokenizer* t) {
+    bloom_free(&t->bloom);
+    if (t->bloom_fpr <= 0.0 || !t->fitted) return;
+    if (!bloom_build(&t->bloom, t->num_categories, t->bloom_fpr)) return;
+    for (size_t i = 0; i < t->num_categories; i++) {
+        bloom_add(&t->bloom, hash_string(t->categories[i]));
+    }
+}
+
+void category_set_bloom(CategoryTokenizer* t, double fpr) {
+    t->bloom_fpr = fpr > 0.0 && fpr < 1.0 ? fpr : 0.0;
+    category_build_bloom(t);
+}
+
+void category_set_order(CategoryTokenizer* t, CategoryOrder order) {
+    t->order = order;
 }
 
 void category_fit(CategoryTokenizer* t, const char** values, size_t n) {
@@ -20,52 +53,280 @@ void category_fit(CategoryTokenizer* t, const char** values, size_t n) {
         return;
     }
 
-    // Temporary storage for unique categories
-    char** unique = malloc(n * sizeof(char*));
-    size_t unique_count = 0;
-
+    // Deduplicate with a hash table instead of a quadratic scan (also counts each key)
+    CategoryCounter counter;
+    category_counter_init(&counter);
     for (size_t i = 0; i < n; i++) {
-        bool found = false;
-        for (size_t j = 0; j < unique_count; j++) {
-            if (strcmp(values[i], unique[j]) == 0) {
-                found = true;
-                break;
-            }
-        }
-        if (!found) {
-            unique[unique_count] = strdup(values[i]);
-            unique_count++;
+        if (!category_counter_add(&counter, values[i], 1)) {
+            category_counter_free(&counter);
+            return;
         }
     }
 
     // Sort categories alphabetically
-    qsort(unique, unique_count, sizeof(char*), compare_strings);
+    if (category_counter_sort(&counter)) {
+        category_fit_counter(t, &counter);
+    }
+    category_counter_free(&counter);
+}
 
-    // Free old categories if they exist
-    if (t->categories) {
-        for (size_t i = 0; i < t->num_categories; i++) {
-            free(t->categories[i]);
+typedef uint64_t u64x4 __attribute__((vector_size(32)));
+
+// First 16 bytes of a key as two zero-padded words
+static inline void key_words(const char* key, size_t len, uint64_t* lo, uint64_t* hi) {
+    unsigned char buf[16] = {0};
+    memcpy(buf, key, len < 16 ? len : 16);
+    memcpy(lo, buf, 8);
+    memcpy(hi, buf + 8, 8);
+}
+
+// Scan keys for the whole vocabulary if it is small, else for the hottest ids of a
+// frequency-ordered one (the linear scan stops at the first match, so hot ids come first)
+static void category_build_small(CategoryTokenizer* t) {
+    free(t->small_keys);
+    t->small_keys = NULL;
+    t->small_padded = 0;
+    if (!t->fitted) return;
+    size_t count = t->num_categories;
+    if (count > CATEGORY_SMALL_VOCAB) {
+        if (t->order != CATEGORY_ORDER_FREQUENCY) return;
+        count = CATEGORY_HOT_KEYS;
+    }
+
+    size_t padded = (count + 3) & ~(size_t)3;
+    uint64_t* keys = NULL;
+    if (posix_memalign((void**)&keys, 32, 3 * padded * sizeof(uint64_t)) != 0) return;
+    for (size_t i = 0; i < padded; i++) {
+        if (i < count) {
+            size_t len = strlen(t->categories[i]);
+            key_words(t->categories[i], len, &keys[i], &keys[padded + i]);
+            keys[2 * padded + i] = len;
+        } else {
+            // Padding lanes never match (no key is that long)
+            keys[i] = keys[padded + i] = 0;
+            keys[2 * padded + i] = UINT64_MAX;
         }
-        free(t->categories);
     }
+    t->small_keys = keys;
+    t->small_padded = padded;
+}
 
-    t->categories = unique;
-    t->num_categories = unique_count;
-    t->fitted = true;
+// Compare the fingerprint (length + first 16 bytes) against four keys per step
+static int small_lookup(const CategoryTokenizer* t, const char* value, size_t len) {
+    uint64_t lo, hi;
+    key_words(value, len, &lo, &hi);
+    size_t padded = t->small_padded;
+    const uint64_t* los = t->small_keys;
+    const uint64_t* his = los + padded;
+    const uint64_t* lens = his + padded;
+    u64x4 qlo = {lo, lo, lo, lo};
+    u64x4 qhi = {hi, hi, hi, hi};
+    u64x4 qlen = {len, len, len, len};
+    for (size_t i = 0; i < padded; i += 4) {
+        u64x4 vlo, vhi, vlen;
+        memcpy(&vlo, los + i, sizeof(vlo));
+        memcpy(&vhi, his + i, sizeof(vhi));
+        memcpy(&vlen, lens + i, sizeof(vlen));
+        u64x4 eq = (vlo == qlo) & (vhi == qhi) & (vlen == qlen);
+        if ((eq[0] | eq[1] | eq[2] | eq[3]) == 0) continue;
+        for (int lane = 0; lane < 4; lane++) {
+            if (eq[lane] && (len <= 16 || memcmp(t->categories[i + lane] + 16, value + 16, len - 16) == 0)) {
+                return (int)(i + lane);
+            }
+        }
+    }
+    return -1;
 }
 
-int category_encode(const CategoryTokenizer* t, const char* value) {
+// First 8 bytes of a key, zero padded, as a big-endian word: words compare like strcmp
+static inline uint64_t key_prefix(const char* key, size_t len) {
+    unsigned char buf[8] = {0};
+    memcpy(buf, key, len < 8 ? len : 8);
+    uint64_t word;
+    memcpy(&word, buf, 8);
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    word = __builtin_bswap64(word);
+#endif
+    return word;
+}
+
+// Place ranks of the sorted order in BFS order by an in-order walk of the implicit tree
+static size_t eytzinger_fill(CategoryTokenizer* t, size_t k, size_t rank) {
+    if (k > t->num_categories) return rank;
+    rank = eytzinger_fill(t, 2 * k, rank);
+    uint32_t id = t->sorted_ids ? t->sorted_ids[rank] : (uint32_t)rank;
+    const char* key = t->categories[id];
+    t->eytzinger_prefixes[k] = key_prefix(key, strlen(key));
+    t->eytzinger_ids[k] = id;
+    return eytzinger_fill(t, 2 * k + 1, rank + 1);
+}
+
+// Search tree for vocabularies too large for the SIMD scan; without it (allocation
+// failure) encode falls back to the plain binary search
+static void category_build_eytzinger(CategoryTokenizer* t) {
+    free(t->eytzinger_prefixes);
+    free(t->eytzinger_ids);
+    t->eytzinger_prefixes = NULL;
+    t->eytzinger_ids = NULL;
+    if (!t->fitted || t->num_categories <= CATEGORY_SMALL_VOCAB || t->num_categories >= UINT32_MAX) return;
+
+    // Aligned so that the 8 nodes from index 8k, three levels below node k, share a line
+    uint64_t* prefixes = NULL;
+    if (posix_memalign((void**)&prefixes, 64, (t->num_categories + 1) * sizeof(uint64_t)) != 0) return;
+    uint32_t* ids = malloc((t->num_categories + 1) * sizeof(uint32_t));
+    if (!ids) {
+        free(prefixes);
+        return;
+    }
+    t->eytzinger_prefixes = prefixes;
+    t->eytzinger_ids = ids;
+    prefixes[0] = 0;
+    ids[0] = 0;
+    eytzinger_fill(t, 1, 0);
+}
+
+// Node of the first key not below the query (0 if every key is below). The descent
+// compares prefixes without branches and prefetches three levels ahead; only equal
+// prefixes need the full strcmp.
+static inline size_t eytzinger_lower_bound(const CategoryTokenizer* t, const char* value, uint64_t prefix) {
+    const uint64_t* prefixes = t->eytzinger_prefixes;
+    size_t n = t->num_categories;
+    size_t k = 1;
+    while (k <= n) {
+        __builtin_prefetch(prefixes + 8 * k);
+        uint64_t p = prefixes[k];
+        size_t less = p < prefix;
+        if (__builtin_expect(p == prefix, 0)) less = strcmp(t->categories[t->eytzinger_ids[k]], value) < 0;
+        k = 2 * k + less;
+    }
+    // Undo the trailing right turns (and the final left one)
+    return k >> __builtin_ffsll((long long)~k);
+}
+
+// Token of value found at node k by eytzinger_lower_bound
+static inline int eytzinger_token(const CategoryTokenizer* t, const char* value, uint64_t prefix, size_t k) {
+    if (k == 0 || t->eytzinger_prefixes[k] != prefix) return 1;  // Unknown category
+    uint32_t id = t->eytzinger_ids[k];
+    return strcmp(t->categories[id], value) == 0 ? (int)id + (2 + t->offset) : 1;
+}
+
+// Whether the scan keys cover only the hot prefix of the vocabulary
+static inline bool small_is_hot(const CategoryTokenizer* t) {
+    return t->small_keys && t->small_padded < t->num_categories;
+}
+
+typedef struct {
+    size_t count;
+    size_t index;   // position in strcmp order
+} RankedKey;
+
+static int compare_ranked(const void* a, const void* b) {
+    const RankedKey* x = a;
+    const RankedKey* y = b;
+    if (x->count != y->count) return x->count > y->count ? -1 : 1;
+    return x->index < y->index ? -1 : x->index > y->index;
+}
+
+// Ids by descending count: categories[id] and sorted_ids (strcmp position -> id)
+static bool frequency_order(const CategoryCounter* c, char** categories, uint32_t* sorted_ids) {
+    RankedKey* ranked = malloc(c->num_keys * sizeof(RankedKey));
+    if (!ranked) return false;
+    for (size_t i = 0; i < c->num_keys; i++) {
+        ranked[i].count = c->counts[i];
+        ranked[i].index = i;
+    }
+    qsort(ranked, c->num_keys, sizeof(RankedKey), compare_ranked);
+    for (size_t id = 0; id < c->num_keys; id++) {
+        categories[id] = c->arena + c->offsets[ranked[id].index];
+        sorted_ids[ranked[id].index] = (uint32_t)id;
+    }
+    free(ranked);
+    return true;
+}
+
+void category_fit_counter(CategoryTokenizer* t, CategoryCounter* c) {
+    char** categories = NULL;
+    uint32_t* sorted_ids = NULL;
+    if (c->num_keys > 0) {
+        categories = malloc(c->num_keys * sizeof(char*));
+        if (!categories) return;
+        if (t->order == CATEGORY_ORDER_FREQUENCY && c->num_keys > 1 && c->num_keys <= UINT32_MAX) {
+            sorted_ids = malloc(c->num_keys * sizeof(uint32_t));
+            if (!sorted_ids || !frequency_order(c, categories, sorted_ids)) {
+                free(categories);
+                free(sorted_ids);
+                return;
+            }
+        } else {
+            for (size_t i = 0; i < c->num_keys; i++) {
+                categories[i] = c->arena + c->offsets[i];
+            }
+        }
+    }
+
+    // Free old categories if they exist
+    free(t->categories);
+    free(t->sorted_ids);
+    free(t->arena);
+
+    t->categories = categories;
+    t->sorted_ids = sorted_ids;
+    t->num_categories = c->num_keys;
+    t->arena = c->arena;
+    t->arena_size = c->arena_size;
+    t->arena_capacity = c->arena_capacity;
+    t->fitted = c->num_keys > 0;
+
+    c->arena = NULL;
+    category_counter_free(c);
+    category_build_bloom(t);
+    category_build_small(t);
+    category_build_eytzinger(t);
+    // The arena grew by doubling; a failed compaction only keeps the slack
+    category_shrink_to_fit(t);
+}
+
+// Token of value if it is settled without the binary search, else ENCODE_SEARCH
+#define ENCODE_SEARCH INT32_MIN
+static int encode_prologue(const CategoryTokenizer* t, const char* value) {
     if (!t->fitted) return -2;  // Not fitted
-    
+
     // Check for NULL/empty string
-    if (!value || strlen(value) == 0) return -1;  // Missing value
+    size_t len = value ? strlen(value) : 0;
+    if (len == 0) return t->offset;  // Missing value
+
+    // Frequency order: the hottest categories are found before the filter and search
+    if (small_is_hot(t)) {
+        int idx = small_lookup(t, value, len);
+        if (idx >= 0) return idx + (2 + t->offset);
+    }
+
+    // Most unknown values stop at a single cache line
+    if (t->bloom.blocks && !bloom_maybe_contains(&t->bloom, hash_bytes(value, len))) return 1;
+
+    if (t->small_keys && !small_is_hot(t)) {
+        int idx = small_lookup(t, value, len);
+        return idx < 0 ? 1 : idx + (2 + t->offset);
+    }
+    return ENCODE_SEARCH;
+}
+
+int category_encode(const CategoryTokenizer* t, const char* value) {
+    int token = encode_prologue(t, value);
+    if (token != ENCODE_SEARCH) return token;
+
+    if (t->eytzinger_prefixes) {
+        uint64_t prefix = key_prefix(value, strlen(value));
+        return eytzinger_token(t, value, prefix, eytzinger_lower_bound(t, value, prefix));
+    }
 
     // Binary search for the category
     int low = 0, high = t->num_categories - 1;
     while (low <= high) {
         int mid = low + (high - low) / 2;
-        int cmp = strcmp(value, t->categories[mid]);
-        if (cmp == 0) return (mid + (2 + t->offset));  // Offset by 1
+        int id = t->sorted_ids ? (int)t->sorted_ids[mid] : mid;
+        int cmp = strcmp(value, t->categories[id]);
+        if (cmp == 0) return (id + (2 + t->offset));  // Offset by 1
         else if (cmp < 0) high = mid - 1;
         else low = mid + 1;
     }
@@ -73,6 +334,80 @@ int category_encode(const CategoryTokenizer* t, const char* value) {
     return 1;  // Unknown category
 }
 
+// Tree descents of up to CATEGORY_PREFETCH_GROUP rows run in lockstep (group
+// prefetching): each pass touches one level for every row, so the cache misses of
+// different rows overlap on top of each descent's own prefetching
+static void search_group(const CategoryTokenizer* t, const char* const* values, const size_t* rows,
+                         size_t count, int* tokens) {
+    const uint64_t* tree = t->eytzinger_prefixes;
+    size_t n = t->num_categories;
+    uint64_t prefixes[CATEGORY_PREFETCH_GROUP];
+    size_t nodes[CATEGORY_PREFETCH_GROUP];
+    for (size_t g = 0; g < count; g++) {
+        const char* value = values[rows[g]];
+        prefixes[g] = key_prefix(value, strlen(value));
+        nodes[g] = 1;
+        __builtin_prefetch(tree + 8);
+    }
+    // Depths differ by at most one level
+    for (bool live = true; live;) {
+        live = false;
+        for (size_t g = 0; g < count; g++) {
+            size_t k = nodes[g];
+            if (k > n) continue;
+            live = true;
+            __builtin_prefetch(tree + 8 * k);
+            uint64_t p = tree[k];
+            size_t less = p < prefixes[g];
+            if (__builtin_expect(p == prefixes[g], 0)) {
+                less = strcmp(t->categories[t->eytzinger_ids[k]], values[rows[g]]) < 0;
+            }
+            nodes[g] = 2 * k + less;
+        }
+    }
+    for (size_t g = 0; g < count; g++) {
+        size_t k = nodes[g] >> __builtin_ffsll((long long)~nodes[g]);
+        tokens[rows[g]] = eytzinger_token(t, values[rows[g]], prefixes[g], k);
+    }
+}
+
+// Rows start..end-1, gathering those that need the vocabulary search into groups
+static void encode_grouped(const CategoryTokenizer* t, const char* const* values, size_t start,
+                               size_t end, int* tokens) {
+    size_t rows[CATEGORY_PREFETCH_GROUP];
+    size_t count = 0;
+    for (size_t i = start; i < end; i++) {
+        int token = encode_prologue(t, values[i]);
+        if (token != ENCODE_SEARCH) {
+            tokens[i] = token;
+            continue;
+        }
+        rows[count++] = i;
+        if (count == CATEGORY_PREFETCH_GROUP) {
+            search_group(t, values, rows, count, tokens);
+            count = 0;
+        }
+    }
+    if (count > 0) search_group(t, values, rows, count, tokens);
+}
+
+void category_encode_batch(const CategoryTokenizer* t, const char* const* values, const uint8_t* validity,
+                           size_t n, int* tokens) {
+    bool grouped = t->eytzinger_prefixes != NULL;
+    size_t end;
+    for (size_t start = 0; start < n; start = end) {
+        bool valid;
+        end = validity_run(validity, n, start, &valid);
+        if (valid && grouped) {
+            encode_grouped(t, values, start, end, tokens);
+        } else if (valid) {
+            for (size_t i = start; i < end; i++) tokens[i] = category_encode(t, values[i]);
+        } else {
+            for (size_t i = start; i < end; i++) tokens[i] = t->offset;
+        }
+    }
+}
+
 const char* category_decode(const CategoryTokenizer* t, int token) {
     if (!t->fitted) return "__not_fitted__";
     if (token - (t->offset) == 0) return "__missing__";
@@ -81,13 +416,433 @@ const char* category_decode(const CategoryTokenizer* t, int token) {
     return t->categories[token - (2 + t->offset)];
 }
 
-void category_free(CategoryTokenizer* t) {
-    if (t->categories) {
-        for (size_t i = 0; i < t->num_categories; i++) {
-            free(t->categories[i]);
+void category_decode_logits(const CategoryTokenizer* t, const float* logits, size_t n, size_t stride,
+                            size_t k, int* tokens) {
+    size_t first = (size_t)t->offset + 2;
+    size_t last = first + t->num_categories;
+    for (size_t r = 0; r < n; r++) {
+        const float* row = logits + r * stride;
+        if (k == 1) {
+            tokens[r] = t->num_categories ? (int)logits_argmax(row, first, last) : -1;
+        } else {
+            logits_topk(row, first, last, k, tokens + r * k);
         }
-        free(t->categories);
     }
+}
+
+void category_memory_usage(const CategoryTokenizer* t, CategoryMemoryUsage* usage) {
+    usage->strings = t->arena_capacity;
+    usage->index = (t->categories ? t->num_categories * sizeof(char*) : 0) +
+                   (t->sorted_ids ? t->num_categories * sizeof(uint32_t) : 0) +
+                   3 * t->small_padded * sizeof(uint64_t) +
+                   (t->eytzinger_prefixes ? (t->num_categories + 1) * (sizeof(uint64_t) + sizeof(uint32_t)) : 0);
+    usage->filter = t->bloom.num_blocks * BLOOM_BLOCK_WORDS * sizeof(uint64_t);
+}
+
+bool category_shrink_to_fit(CategoryTokenizer* t) {
+    if (!t->arena || t->arena_capacity == t->arena_size) return true;
+    char* arena = malloc(t->arena_size);
+    if (!arena) return false;
+    memcpy(arena, t->arena, t->arena_size);
+    for (size_t i = 0; i < t->num_categories; i++) {
+        t->categories[i] = arena + (t->categories[i] - t->arena);
+    }
+    free(t->arena);
+    t->arena = arena;
+    t->arena_capacity = t->arena_size;
+    return true;
+}
+
+void category_free(CategoryTokenizer* t) {
+    free(t->categories);
+    free(t->sorted_ids);
+    free(t->arena);
+    t->categories = NULL;
+    t->sorted_ids = NULL;
+    t->arena = NULL;
+    t->arena_size = 0;
+    t->arena_capacity = 0;
     t->num_categories = 0;
     t->fitted = false;
-}
\ No newline at end of file
+    bloom_free(&t->bloom);
+    free(t->small_keys);
+    t->small_keys = NULL;
+    t->small_padded = 0;
+    free(t->eytzinger_prefixes);
+    free(t->eytzinger_ids);
+    t->eytzinger_prefixes = NULL;
+    t->eytzinger_ids = NULL;
+}
+
+// =====================
+// Partial fit states
+// =====================
+void category_counter_init(CategoryCounter* c) {
+    c->arena = NULL;
+    c->arena_size = 0;
+    c->arena_capacity = 0;
+    c->offsets = NULL;
+    c->lengths = NULL;
+    c->counts = NULL;
+    c->num_keys = 0;
+    c->capacity = 0;
+    c->slots = NULL;
+    c->num_slots = 0;
+}
+
+static bool counter_rehash(CategoryCounter* c, size_t num_slots) {
+    size_t* slots = calloc(num_slots, sizeof(size_t));
+    if (!slots) return false;
+    size_t mask = num_slots - 1;
+    for (size_t i = 0; i < c->num_keys; i++) {
+        size_t pos = hash_bytes(category_counter_key(c, i), c->lengths[i]) & mask;
+        while (slots[pos]) pos = (pos + 1) & mask;
+        slots[pos] = i + 1;
+    }
+    free(c->slots);
+    c->slots = slots;
+    c->num_slots = num_slots;
+    return true;
+}
+
+// Copy a key into the arena and append it
+static bool counter_append(CategoryCounter* c, const char* key, size_t len, size_t count) {
+    if (c->num_keys == c->capacity) {
+        size_t capacity = c->capacity ? c->capacity * 2 : 64;
+        size_t* offsets = realloc(c->offsets, capacity * sizeof(size_t));
+        if (!offsets) return false;
+        c->offsets = offsets;
+        size_t* lengths = realloc(c->lengths, capacity * sizeof(size_t));
+        if (!lengths) return false;
+        c->lengths = lengths;
+        size_t* counts = realloc(c->counts, capacity * sizeof(size_t));
+        if (!counts) return false;
+        c->counts = counts;
+        c->capacity = capacity;
+    }
+    if (c->arena_size + len + 1 > c->arena_capacity) {
+        size_t arena_capacity = c->arena_capacity ? c->arena_capacity : 1024;
+        while (c->arena_size + len + 1 > arena_capacity) arena_capacity *= 2;
+        char* arena = realloc(c->arena, arena_capacity);
+        if (!arena) return false;
+        c->arena = arena;
+        c->arena_capacity = arena_capacity;
+    }
+    memcpy(c->arena + c->arena_size, key, len);
+    c->arena[c->arena_size + len] = '\0';
+    c->offsets[c->num_keys] = c->arena_size;
+    c->lengths[c->num_keys] = len;
+    c->counts[c->num_keys] = count;
+    c->arena_size += len + 1;
+    c->num_keys++;
+    return true;
+}
+
+bool category_counter_add(CategoryCounter* c, const char* value, size_t count) {
+    // Keep the load factor at or below 1/2 (also builds the table for merged counters)
+    if (2 * (c->num_keys + 1) > c->num_slots) {
+        size_t num_slots = c->num_slots ? c->num_slots : 128;
+        while (2 * (c->num_keys + 1) > num_slots) num_slots *= 2;
+        if (!counter_rehash(c, num_slots)) return false;
+    }
+
+    size_t len = strlen(value);
+    size_t mask = c->num_slots - 1;
+    size_t pos = hash_bytes(value, len) & mask;
+    while (c->slots[pos]) {
+        size_t idx = c->slots[pos] - 1;
+        if (c->lengths[idx] == len && memcmp(category_counter_key(c, idx), value, len) == 0) {
+            c->counts[idx] += count;
+            return true;
+        }
+        pos = (pos + 1) & mask;
+    }
+
+    if (!counter_append(c, value, len, count)) return false;
+    c->slots[pos] = c->num_keys;
+    return true;
+}
+
+bool category_counter_sort(CategoryCounter* c) {
+    if (c->num_keys < 2) return true;
+    size_t n = c->num_keys;
+    const char** keys = malloc(n * sizeof(char*));
+    size_t* order = malloc(n * sizeof(size_t));
+    size_t* scratch = malloc(n * sizeof(size_t));
+    bool ok = keys && order && scratch;
+    if (ok) {
+        for (size_t i = 0; i < n; i++) keys[i] = category_counter_key(c, i);
+        ok = strsort(keys, c->lengths, n, order);
+    }
+    if (ok) {
+        // Apply the permutation to every per-key array
+        size_t* arrays[3] = {c->offsets, c->lengths, c->counts};
+        for (int a = 0; a < 3; a++) {
+            for (size_t i = 0; i < n; i++) scratch[i] = arrays[a][order[i]];
+            memcpy(arrays[a], scratch, n * sizeof(size_t));
+        }
+        // Key positions changed
+        free(c->slots);
+        c->slots = NULL;
+        c->num_slots = 0;
+    }
+    free(keys);
+    free(order);
+    free(scratch);
+    return ok;
+}
+
+void category_counter_free(CategoryCounter* c) {
+    free(c->arena);
+    free(c->offsets);
+    free(c->lengths);
+    free(c->counts);
+    free(c->slots);
+    category_counter_init(c);
+}
+
+static inline double reservoir_uniform(CategoryReservoir* r) {
+    r->rng += 0x9e3779b97f4a7c15ULL;
+    return ((double)(hash_mix(r->rng) >> 11) + 0.5) * (1.0 / 9007199254740992.0);
+}
+
+// Draw the gap to the next admitted item
+static void reservoir_skip(CategoryReservoir* r) {
+    r->w *= exp(log(reservoir_uniform(r)) / (double)r->capacity);
+    double gap = floor(log(reservoir_uniform(r)) / log1p(-r->w));
+    r->next = gap < 9.0e18 ? r->seen + (uint64_t)gap : UINT64_MAX;
+}
+
+bool category_reservoir_init(CategoryReservoir* r, size_t capacity, uint64_t seed) {
+    r->items = capacity ? calloc(capacity, sizeof(char*)) : NULL;
+    r->capacity = capacity;
+    r->size = 0;
+    r->seen = 0;
+    r->next = 0;
+    r->w = 1.0;
+    r->rng = seed;
+    return r->items != NULL;
+}
+
+bool category_reservoir_add(CategoryReservoir* r, const char* value) {
+    if (r->size < r->capacity) {
+        r->items[r->size] = strdup(value);
+        if (!r->items[r->size]) return false;
+        r->size++;
+        r->seen++;
+        if (r->size == r->capacity) reservoir_skip(r);
+        return true;
+    }
+    if (r->seen++ == r->next) {
+        char* item = strdup(value);
+        if (!item) return false;
+        size_t slot = (size_t)(reservoir_uniform(r) * (double)r->capacity);
+        if (slot >= r->capacity) slot = r->capacity - 1;
+        free(r->items[slot]);
+        r->items[slot] = item;
+        reservoir_skip(r);
+    }
+    return true;
+}
+
+void category_reservoir_free(CategoryReservoir* r) {
+    for (size_t i = 0; i < r->size; i++) {
+        free(r->items[i]);
+    }
+    free(r->items);
+    r->items = NULL;
+    r->size = 0;
+    r->capacity = 0;
+}
+
+static size_t varint_size(uint64_t v) {
+    size_t n = 1;
+    while (v >= 0x80) {
+        v >>= 7;
+        n++;
+    }
+    return n;
+}
+
+static unsigned char* varint_write(unsigned char* p, uint64_t v) {
+    while (v >= 0x80) {
+        *p++ = (unsigned char)(v | 0x80);
+        v >>= 7;
+    }
+    *p++ = (unsigned char)v;
+    return p;
+}
+
+static bool varint_read(const unsigned char** p, const unsigned char* end, uint64_t* v) {
+    uint64_t result = 0;
+    for (int shift = 0; shift < 64 && *p < end; shift += 7) {
+        unsigned char byte = *(*p)++;
+        result |= (uint64_t)(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) {
+            *v = result;
+            return true;
+        }
+    }
+    return false;
+}
+
+static size_t common_prefix(const char* a, const char* b) {
+    size_t n = 0;
+    while (a[n] && a[n] == b[n]) n++;
+    return n;
+}
+
+// Layout: magic, version, varint num_keys, then per key (front coded):
+// varint shared prefix, varint suffix length, suffix bytes, varint count
+bool category_partial_serialize(const CategoryCounter* c, unsigned char** out, size_t* size) {
+    size_t total = 5 + varint_size(c->num_keys);
+    const char* prev = "";
+    for (size_t i = 0; i < c->num_keys; i++) {
+        const char* key = category_counter_key(c, i);
+        size_t shared = common_prefix(prev, key);
+        size_t suffix = c->lengths[i] - shared;
+        total += varint_size(shared) + varint_size(suffix) + suffix + varint_size(c->counts[i]);
+        prev = key;
+    }
+
+    unsigned char* buffer = malloc(total);
+    if (!buffer) return false;
+    unsigned char* p = buffer;
+    memcpy(p, PARTIAL_MAGIC, 4);
+    p[4] = PARTIAL_VERSION;
+    p = varint_write(p + 5, c->num_keys);
+    prev = "";
+    for (size_t i = 0; i < c->num_keys; i++) {
+        const char* key = category_counter_key(c, i);
+        size_t shared = common_prefix(prev, key);
+        size_t suffix = c->lengths[i] - shared;
+        p = varint_write(p, shared);
+        p = varint_write(p, suffix);
+        memcpy(p, key + shared, suffix);
+        p = varint_write(p + suffix, c->counts[i]);
+        prev = key;
+    }
+
+    *out = buffer;
+    *size = total;
+    return true;
+}
+
+// Decoding cursor over one serialized partial
+typedef struct {
+    const unsigned char* p;
+    const unsigned char* end;
+    uint64_t remaining;
+    char* key;
+    size_t key_len;
+    size_t key_cap;
+    size_t count;
+} PartialCursor;
+
+// Advance to the next key; false on exhaustion or malformed input (see *error)
+static bool cursor_next(PartialCursor* cur, bool* error) {
+    if (cur->remaining == 0) return false;
+    uint64_t shared, suffix, count;
+    if (!varint_read(&cur->p, cur->end, &shared) ||
+        !varint_read(&cur->p, cur->end, &suffix) ||
+        shared > cur->key_len || suffix > (uint64_t)(cur->end - cur->p)) {
+        *error = true;
+        return false;
+    }
+    size_t len = shared + suffix;
+    if (len + 1 > cur->key_cap) {
+        size_t cap = cur->key_cap ? cur->key_cap : 32;
+        while (cap < len + 1) cap *= 2;
+        char* key = realloc(cur->key, cap);
+        if (!key) {
+            *error = true;
+            return false;
+        }
+        cur->key = key;
+        cur->key_cap = cap;
+    }
+    // Keys must be NUL free (the empty key is valid, as in fit); ordering is checked by the merge
+    memcpy(cur->key + shared, cur->p, suffix);
+    cur->key[len] = '\0';
+    cur->p += suffix;
+    if (strlen(cur->key) != len || !varint_read(&cur->p, cur->end, &count)) {
+        *error = true;
+        return false;
+    }
+    cur->key_len = len;
+    cur->count = count;
+    cur->remaining--;
+    return true;
+}
+
+static bool heap_less(PartialCursor* cursors, size_t a, size_t b) {
+    return strcmp(cursors[a].key, cursors[b].key) < 0;
+}
+
+static void heap_sift_down(size_t* heap, size_t size, size_t i, PartialCursor* cursors) {
+    for (;;) {
+        size_t smallest = i, l = 2 * i + 1, r = 2 * i + 2;
+        if (l < size && heap_less(cursors, heap[l], heap[smallest])) smallest = l;
+        if (r < size && heap_less(cursors, heap[r], heap[smallest])) smallest = r;
+        if (smallest == i) return;
+        size_t tmp = heap[i];
+        heap[i] = heap[smallest];
+        heap[smallest] = tmp;
+        i = smallest;
+    }
+}
+
+bool category_partial_merge(const unsigned char** partials, const size_t* sizes, size_t k, CategoryCounter* out) {
+    category_counter_init(out);
+    PartialCursor* cursors = calloc(k ? k : 1, sizeof(PartialCursor));
+    size_t* heap = malloc((k ? k : 1) * sizeof(size_t));
+    bool error = !cursors || !heap;
+    size_t heap_size = 0;
+
+    for (size_t i = 0; i < k && !error; i++) {
+        if (sizes[i] < 5 || memcmp(partials[i], PARTIAL_MAGIC, 4) != 0 ||
+            partials[i][4] != PARTIAL_VERSION) {
+            error = true;
+            break;
+        }
+        cursors[i].p = partials[i] + 5;
+        cursors[i].end = partials[i] + sizes[i];
+        if (!varint_read(&cursors[i].p, cursors[i].end, &cursors[i].remaining)) {
+            error = true;
+            break;
+        }
+        if (cursor_next(&cursors[i], &error)) heap[heap_size++] = i;
+    }
+    for (size_t i = heap_size / 2; i-- > 0 && !error;) {
+        heap_sift_down(heap, heap_size, i, cursors);
+    }
+
+    // Pop the smallest key, folding equal keys from other partials into it
+    while (heap_size > 0 && !error) {
+        PartialCursor* top = &cursors[heap[0]];
+        int cmp = out->num_keys > 0 ? strcmp(category_counter_key(out, out->num_keys - 1), top->key) : -1;
+        if (cmp > 0) {
+            error = true;  // a partial was not sorted
+            break;
+        } else if (cmp == 0) {
+            out->counts[out->num_keys - 1] += top->count;
+        } else {
+            if (!counter_append(out, top->key, top->key_len, top->count)) {
+                error = true;
+                break;
+            }
+        }
+        if (!cursor_next(top, &error)) {
+            heap[0] = heap[--heap_size];
+        }
+        heap_sift_down(heap, heap_size, 0, cursors);
+    }
+
+    for (size_t i = 0; cursors && i < k; i++) {
+        free(cursors[i].key);
+    }
+    free(cursors);
+    free(heap);
+    if (error) category_counter_free(out);
+    return !error;
+}
@@ -3,27 +3,146 @@
 
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
+#include "bloom.h"
+#include "validity.h"
+
+// How fit assigns token ids
+typedef enum {
+    CATEGORY_ORDER_SORTED,      // strcmp order of the categories
+    CATEGORY_ORDER_FREQUENCY    // descending count, ties in strcmp order
+} CategoryOrder;
 
 typedef struct __attribute__((aligned(8))) {
-    char** categories;
+    char** categories;  // in token order, pointing into arena
     size_t num_categories;
+    uint32_t* sorted_ids;   // ids in strcmp order (NULL when ids already are)
+    char* arena;        // category strings back to back, NUL terminated
+    size_t arena_size;
+    size_t arena_capacity;
     bool fitted;
     int offset;
+    double bloom_fpr;   // false positive rate of the unknown filter (0 = disabled)
+    BloomFilter bloom;
+    CategoryOrder order;
+    uint64_t* small_keys;   // small vocabularies (or the hot prefix): bytes 0-7, bytes 8-15 and lengths, padded to 4
+    size_t small_padded;
+    uint64_t* eytzinger_prefixes;   // larger vocabularies: big-endian first 8 bytes in BFS order, from index 1
+    uint32_t* eytzinger_ids;        // token id of each node
 } CategoryTokenizer;
 
+// Heap bytes held by a tokenizer, by structure
+typedef struct __attribute__((aligned(8))) {
+    size_t strings;     // category string arena
+    size_t index;       // category pointers, SIMD scan keys and search tree
+    size_t filter;      // unknown-category Bloom filter
+} CategoryMemoryUsage;
+
+// Vocabularies up to this size are encoded with a SIMD linear scan
+#define CATEGORY_SMALL_VOCAB 128
+
+// Larger frequency-ordered vocabularies scan this many hottest ids before searching
+#define CATEGORY_HOT_KEYS 32
+
+// Batch encodes run this many tree searches in lockstep
+#define CATEGORY_PREFETCH_GROUP 16
+
+// Unique keys with occurrence counts (the partial fit state)
+typedef struct __attribute__((aligned(8))) {
+    char* arena;        // keys back to back, NUL terminated
+    size_t arena_size;
+    size_t arena_capacity;
+    size_t* offsets;    // key start within the arena
+    size_t* lengths;
+    size_t* counts;
+    size_t num_keys;
+    size_t capacity;
+    size_t* slots;      // open addressing table of key index + 1 (0 = empty)
+    size_t num_slots;
+} CategoryCounter;
+
+// Uniform fixed-size sample of a stream of strings (Algorithm L)
+typedef struct __attribute__((aligned(8))) {
+    char** items;
+    size_t capacity;
+    size_t size;
+    uint64_t seen;
+    uint64_t next;      // index of the next item to admit once full
+    double w;
+    uint64_t rng;
+} CategoryReservoir;
+
 // Initialize tokenizer
 void category_init(CategoryTokenizer* t, int offset);
 
+// Enable (fpr in (0, 1)) or disable (0) the unknown-category filter; rebuilt if fitted
+void category_set_bloom(CategoryTokenizer* t, double fpr);
+
+// Set how later fits assign token ids
+void category_set_order(CategoryTokenizer* t, CategoryOrder order);
+
 // Fit to data (extract unique categories)
 void category_fit(CategoryTokenizer* t, const char** values, size_t n);
 
+// Fit from a counter sorted in strcmp order; takes ownership of its keys and leaves it empty
+void category_fit_counter(CategoryTokenizer* t, CategoryCounter* c);
+
 // Encode value into tokens
 int category_encode(const CategoryTokenizer* t, const char* value);
 
+// Encode n values; rows missing from the validity bitmap (optional) encode to the
+// missing token, offset, and values of missing rows are not read. Searches of larger
+// vocabularies run in groups with software prefetching.
+void category_encode_batch(const CategoryTokenizer* t, const char* const* values, const uint8_t* validity,
+                           size_t n, int* tokens);
+
 // Decode token into value
 const char* category_decode(const CategoryTokenizer* t, int token);
 
+// Decode n rows of stride logits into the k most likely category tokens per row,
+// best first (the sentinel tokens are never chosen; -1 where fewer than k exist)
+void category_decode_logits(const CategoryTokenizer* t, const float* logits, size_t n, size_t stride,
+                            size_t k, int* tokens);
+
+// Report the heap bytes held by the tokenizer
+void category_memory_usage(const CategoryTokenizer* t, CategoryMemoryUsage* usage);
+
+// Release unused capacity (false on allocation failure; the tokenizer stays valid)
+bool category_shrink_to_fit(CategoryTokenizer* t);
+
 // Free resources
 void category_free(CategoryTokenizer* t);
 
-#endif
\ No newline at end of file
+// Initialize an empty counter
+void category_counter_init(CategoryCounter* c);
+
+// Add `count` occurrences of value (returns false on allocation failure)
+bool category_counter_add(CategoryCounter* c, const char* value, size_t count);
+
+// Key i of the counter
+static inline const char* category_counter_key(const CategoryCounter* c, size_t i) {
+    return c->arena + c->offsets[i];
+}
+
+// Sort keys (and their counts) in strcmp order (false on allocation failure)
+bool category_counter_sort(CategoryCounter* c);
+
+// Free resources
+void category_counter_free(CategoryCounter* c);
+
+// Initialize an empty reservoir holding up to capacity items
+bool category_reservoir_init(CategoryReservoir* r, size_t capacity, uint64_t seed);
+
+// Offer one value to the sample (false on allocation failure)
+bool category_reservoir_add(CategoryReservoir* r, const char* value);
+
+// Free resources
+void category_reservoir_free(CategoryReservoir* r);
+
+// Serialize a sorted counter into a newly malloc'd buffer
+bool category_partial_serialize(const CategoryCounter* c, unsigned char** out, size_t* size);
+
+// K-way merge of serialized partials into a sorted counter (false on malformed input)
+bool category_partial_merge(const unsigned char** partials, const size_t* sizes, size_t k, CategoryCounter* out);
+
+#endif
@@ -0,0 +1,518 @@
+#include "codec.h"
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define CODEC_X86 1
+#endif
+
+#define CODEC_MAGIC "ZFTC"
+#define CODEC_VERSION 1
+#define CODEC_HEADER_SIZE 24
+#define CODEC_TIMESTAMP_COLUMNS 6
+#define CODEC_UNPACK_BLOCK 1024
+
+enum { CATEGORY_PACKED = 0, CATEGORY_RLE = 1 };
+
+// --- Little endian field access ---
+
+static inline void put_u32(unsigned char* p, uint32_t v) {
+    for (int i = 0; i < 4; i++) p[i] = (unsigned char)(v >> (8 * i));
+}
+
+static inline void put_u64(unsigned char* p, uint64_t v) {
+    for (int i = 0; i < 8; i++) p[i] = (unsigned char)(v >> (8 * i));
+}
+
+static inline uint32_t get_u32(const unsigned char* p) {
+    uint32_t v = 0;
+    for (int i = 0; i < 4; i++) v |= (uint32_t)p[i] << (8 * i);
+    return v;
+}
+
+static inline uint64_t get_u64(const unsigned char* p) {
+    uint64_t v = 0;
+    for (int i = 0; i < 8; i++) v |= (uint64_t)p[i] << (8 * i);
+    return v;
+}
+
+// --- StreamVByte: 2-bit length codes, 4 per control byte, then the data bytes ---
+
+static uint8_t svb_lengths[256];
+static uint8_t svb_shuffles[256][16];
+static pthread_once_t svb_once = PTHREAD_ONCE_INIT;
+
+static void svb_build_tables(void) {
+    for (int c = 0; c < 256; c++) {
+        int pos = 0;
+        for (int k = 0; k < 4; k++) {
+            int len = ((c >> (2 * k)) & 3) + 1;
+            for (int b = 0; b < 4; b++) {
+                svb_shuffles[c][4 * k + b] = b < len ? (uint8_t)(pos + b) : 0xff;
+            }
+            pos += len;
+        }
+        svb_lengths[c] = (uint8_t)pos;
+    }
+}
+
+static inline int svb_code(uint32_t v) {
+    return (v >= (1u << 8)) + (v >= (1u << 16)) + (v >= (1u << 24));
+}
+
+static inline size_t svb_control_size(size_t n) {
+    return (n + 3) / 4;
+}
+
+typedef struct {
+    unsigned char* control;
+    unsigned char* data;
+    size_t count;
+} SvbWriter;
+
+// The caller reserves svb_control_size(n) bytes of control before the data
+static inline void svb_writer_init(SvbWriter* w, unsigned char* out, size_t n) {
+    w->control = out;
+    w->data = out + svb_control_size(n);
+    w->count = 0;
+    memset(out, 0, svb_control_size(n));
+}
+
+static inline void svb_put(SvbWriter* w, uint32_t v) {
+    int code = svb_code(v);
+    w->control[w->count >> 2] |= (unsigned char)(code << (2 * (w->count & 3)));
+    for (int b = 0; b <= code; b++) *w->data++ = (unsigned char)(v >> (8 * b));
+    w->count++;
+}
+
+// Bytes written by a finished writer
+static inline size_t svb_writer_size(const SvbWriter* w, const unsigned char* out) {
+    return (size_t)(w->data - out);
+}
+
+static inline uint32_t svb_get(const unsigned char* data, int code) {
+    uint32_t v = 0;
+    for (int b = 0; b <= code; b++) v |= (uint32_t)data[b] << (8 * b);
+    return v;
+}
+
+// Decode the quads whose 16-byte load stays inside the buffer; returns quads done
+#ifdef CODEC_X86
+__attribute__((target("ssse3")))
+static size_t svb_decode_ssse3(const unsigned char* control, const unsigned char** data,
+                               const unsigned char* end, size_t quads, uint32_t* out) {
+    const unsigned char* p = *data;
+    size_t q = 0;
+    for (; q < quads && end - p >= 16; q++) {
+        unsigned char c = control[q];
+        __m128i v = _mm_loadu_si128((const __m128i*)p);
+        v = _mm_shuffle_epi8(v, _mm_loadu_si128((const __m128i*)svb_shuffles[c]));
+        _mm_storeu_si128((__m128i*)(out + 4 * q), v);
+        p += svb_lengths[c];
+    }
+    *data = p;
+    return q;
+}
+#endif
+
+// Decode n values from in[0, size); returns bytes consumed or 0 on truncated input
+static size_t svb_decode(const unsigned char* in, size_t size, size_t n, uint32_t* out) {
+    pthread_once(&svb_once, svb_build_tables);
+    size_t control_size = svb_control_size(n);
+    if (n == 0) return 0;
+    if (control_size > size) return 0;
+
+    // Validate the data length up front so the decode loops need no checks
+    size_t quads = n / 4;
+    size_t data_size = 0;
+    for (size_t q = 0; q < quads; q++) data_size += svb_lengths[in[q]];
+    for (size_t i = quads * 4; i < n; i++) data_size += ((in[i >> 2] >> (2 * (i & 3))) & 3) + 1;
+    if (data_size > size - control_size) return 0;
+
+    const unsigned char* data = in + control_size;
+    const unsigned char* end = in + size;
+    size_t q = 0;
+#ifdef CODEC_X86
+    if (__builtin_cpu_supports("ssse3")) q = svb_decode_ssse3(in, &data, end, quads, out);
+#endif
+    for (size_t i = 4 * q; i < n; i++) {
+        int code = (in[i >> 2] >> (2 * (i & 3))) & 3;
+        out[i] = svb_get(data, code);
+        data += code + 1;
+    }
+    return control_size + data_size;
+}
+
+// --- Frame of reference bit-packing ---
+
+static inline int bit_width(uint32_t range) {
+    return range ? 32 - __builtin_clz(range) : 0;
+}
+
+static inline size_t packed_size(size_t n, int width) {
+    return ((n * (size_t)width + 63) / 64) * 8;
+}
+
+// Pack (values[i * stride] - base) in width bits each, LSB first
+static size_t bitpack(const int32_t* values, size_t n, size_t stride, int32_t base, int width, unsigned char* out) {
+    size_t size = packed_size(n, width);
+    if (width == 0) return 0;
+    uint64_t acc = 0;
+    int filled = 0;
+    unsigned char* p = out;
+    for (size_t i = 0; i < n; i++) {
+        uint64_t v = (uint32_t)((uint32_t)values[i * stride] - (uint32_t)base);
+        acc |= v << filled;
+        filled += width;
+        if (filled >= 64) {
+            put_u64(p, acc);
+            p += 8;
+            filled -= 64;
+            acc = filled ? v >> (width - filled) : 0;
+        }
+    }
+    if (filled) put_u64(p, acc);
+    return size;
+}
+
+static inline uint64_t load_u64(const unsigned char* p) {
+    uint64_t v;
+    memcpy(&v, p, 8);
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    v = __builtin_bswap64(v);
+#endif
+    return v;
+}
+
+// Eight values span 8 * width bits, so every group starts on a byte boundary.
+// Each half of the group is one 16-byte load; the shuffle gathers the 4 bytes
+// holding each value into its lane and a per-lane shift drops the leading bits.
+// A value plus its bit offset fits those 4 bytes up to UNPACK_MAX_WIDTH.
+#define UNPACK_MAX_WIDTH 25
+
+#ifdef CODEC_X86
+static uint8_t unpack_shuffles[UNPACK_MAX_WIDTH + 1][32];
+static uint32_t unpack_shifts[UNPACK_MAX_WIDTH + 1][8];
+static pthread_once_t unpack_once = PTHREAD_ONCE_INIT;
+
+static void unpack_build_tables(void) {
+    for (int w = 1; w <= UNPACK_MAX_WIDTH; w++) {
+        for (int k = 0; k < 8; k++) {
+            int bit = k * w;
+            int byte = (bit >> 3) - (k < 4 ? 0 : (4 * w) >> 3);
+            for (int b = 0; b < 4; b++) unpack_shuffles[w][4 * k + b] = (uint8_t)(byte + b);
+            unpack_shifts[w][k] = (uint32_t)(bit & 7);
+        }
+    }
+}
+
+// Unpack the groups whose loads stay inside the packed data; returns values done
+__attribute__((target("avx2")))
+static size_t bitunpack_avx2(const unsigned char* in, size_t size, size_t n, int32_t base, int width, int32_t* out) {
+    __m256i shuffle = _mm256_loadu_si256((const __m256i*)unpack_shuffles[width]);
+    __m256i shifts = _mm256_loadu_si256((const __m256i*)unpack_shifts[width]);
+    __m256i mask = _mm256_set1_epi32((int32_t)((1u << width) - 1));
+    __m256i offset = _mm256_set1_epi32(base);
+    size_t half = (size_t)(4 * width) >> 3;
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const unsigned char* p = in + ((i * (size_t)width) >> 3);
+        if ((size_t)(p - in) + half + 16 > size) break;
+        __m128i lo = _mm_loadu_si128((const __m128i*)p);
+        __m128i hi = _mm_loadu_si128((const __m128i*)(p + half));
+        __m256i v = _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+        v = _mm256_shuffle_epi8(v, shuffle);
+        v = _mm256_and_si256(_mm256_srlv_epi32(v, shifts), mask);
+        _mm256_storeu_si256((__m256i*)(out + i), _mm256_add_epi32(v, offset));
+    }
+    return i;
+}
+#endif
+
+// Widths up to UNPACK_MAX_WIDTH go eight at a time through AVX2 when the CPU
+// has it. Otherwise each value is one unaligned load and shift; the last few
+// values, whose 8-byte load would run past the packed data, go through get_u64
+// on a copy. size is the readable bytes from in, at least the n values' bits
+static void bitunpack(const unsigned char* in, size_t size, size_t n, int32_t base, int width, int32_t* out) {
+    if (width == 0) {
+        for (size_t i = 0; i < n; i++) out[i] = base;
+        return;
+    }
+    uint64_t mask = width == 32 ? 0xffffffffULL : (1ULL << width) - 1;
+    size_t fast = size >= 8 ? ((size - 8) * 8) / (size_t)width + 1 : 0;
+    if (fast > n) fast = n;
+    size_t done = 0;
+#ifdef CODEC_X86
+    if (width <= UNPACK_MAX_WIDTH && __builtin_cpu_supports("avx2")) {
+        pthread_once(&unpack_once, unpack_build_tables);
+        done = bitunpack_avx2(in, size, n, base, width, out);
+    }
+#endif
+    for (size_t i = done; i < fast; i++) {
+        size_t bit = i * (size_t)width;
+        uint64_t v = (load_u64(in + (bit >> 3)) >> (bit & 7)) & mask;
+        out[i] = (int32_t)((uint32_t)base + (uint32_t)v);
+    }
+    unsigned char tail[16] = {0};
+    for (size_t i = done > fast ? done : fast; i < n; i++) {
+        size_t bit = i * (size_t)width;
+        size_t byte = bit >> 3;
+        memcpy(tail, in + byte, size - byte < 16 ? size - byte : 16);
+        uint64_t v = (get_u64(tail) >> (bit & 7)) & mask;
+        out[i] = (int32_t)((uint32_t)base + (uint32_t)v);
+    }
+}
+
+static void min_max(const int32_t* values, size_t n, size_t stride, int32_t* lo, int32_t* hi) {
+    int32_t mn = n ? values[0] : 0, mx = mn;
+    for (size_t i = 1; i < n; i++) {
+        int32_t v = values[i * stride];
+        if (v < mn) mn = v;
+        if (v > mx) mx = v;
+    }
+    *lo = mn;
+    *hi = mx;
+}
+
+// --- Header ---
+
+static void write_header(unsigned char* out, CodecLayout layout, size_t num_rows, size_t num_tokens) {
+    memcpy(out, CODEC_MAGIC, 4);
+    out[4] = CODEC_VERSION;
+    out[5] = (unsigned char)layout;
+    out[6] = out[7] = 0;
+    put_u64(out + 8, num_rows);
+    put_u64(out + 16, num_tokens);
+}
+
+bool codec_info(const unsigned char* in, size_t size, CodecInfo* info) {
+    if (size < CODEC_HEADER_SIZE || memcmp(in, CODEC_MAGIC, 4) != 0 || in[4] != CODEC_VERSION) return false;
+    if (in[5] < CODEC_CATEGORY || in[5] > CODEC_TIMESTAMP) return false;
+    info->layout = (CodecLayout)in[5];
+    info->num_rows = get_u64(in + 8);
+    info->num_tokens = get_u64(in + 16);
+    // Reject counts no allocation could hold
+    if (info->num_rows > ((size_t)1 << 40) || info->num_tokens > ((size_t)1 << 40)) return false;
+    switch (info->layout) {
+        case CODEC_CATEGORY: return info->num_tokens == info->num_rows;
+        case CODEC_TIMESTAMP: return info->num_tokens == info->num_rows * CODEC_TIMESTAMP_COLUMNS;
+        default: return true;
+    }
+}
+
+size_t codec_bound(size_t num_tokens, size_t num_rows) {
+    return CODEC_HEADER_SIZE + 128 + 5 * (num_tokens + num_rows);
+}
+
+// --- Category: runs of equal tokens, or packed when runs are short ---
+
+size_t codec_compress_category(const int32_t* tokens, size_t num_rows, unsigned char* out) {
+    write_header(out, CODEC_CATEGORY, num_rows, num_rows);
+    unsigned char* p = out + CODEC_HEADER_SIZE;
+    int32_t lo, hi;
+    min_max(tokens, num_rows, 1, &lo, &hi);
+    int width = bit_width((uint32_t)hi - (uint32_t)lo);
+
+    size_t runs = 0, values_size = 0, lengths_size = 0;
+    for (size_t i = 0; i < num_rows;) {
+        size_t j = i + 1;
+        while (j < num_rows && tokens[j] == tokens[i]) j++;
+        values_size += svb_code((uint32_t)tokens[i] - (uint32_t)lo) + 1;
+        lengths_size += svb_code((uint32_t)(j - i - 1)) + 1;
+        runs++;
+        i = j;
+    }
+    values_size += svb_control_size(runs);
+    lengths_size += svb_control_size(runs);
+
+    put_u32(p, (uint32_t)lo);
+    p += 4;
+    size_t rle_size = 1 + 16 + values_size + lengths_size;
+    if (rle_size >= 2 + packed_size(num_rows, width)) {
+        *p++ = CATEGORY_PACKED;
+        *p++ = (unsigned char)width;
+        p += bitpack(tokens, num_rows, 1, lo, width, p);
+        return (size_t)(p - out);
+    }
+
+    *p++ = CATEGORY_RLE;
+    put_u64(p, runs);
+    put_u64(p + 8, values_size);
+    p += 16;
+    SvbWriter values, lengths;
+    svb_writer_init(&values, p, runs);
+    svb_writer_init(&lengths, p + values_size, runs);
+    for (size_t i = 0; i < num_rows;) {
+        size_t j = i + 1;
+        while (j < num_rows && tokens[j] == tokens[i]) j++;
+        svb_put(&values, (uint32_t)tokens[i] - (uint32_t)lo);
+        svb_put(&lengths, (uint32_t)(j - i - 1));
+        i = j;
+    }
+    return (size_t)(p - out) + values_size + lengths_size;
+}
+
+static bool decompress_category(const unsigned char* p, const unsigned char* end, size_t n, int32_t* tokens) {
+    if (end - p < 5) return false;
+    int32_t lo = (int32_t)get_u32(p);
+    int mode = p[4];
+    p += 5;
+    if (mode == CATEGORY_PACKED) {
+        if (end - p < 1 || p[0] > 32) return false;
+        int width = p[0];
+        p++;
+        if ((size_t)(end - p) < packed_size(n, width)) return false;
+        bitunpack(p, packed_size(n, width), n, lo, width, tokens);
+        return true;
+    }
+    if (mode != CATEGORY_RLE || end - p < 16) return false;
+    size_t runs = get_u64(p);
+    size_t values_size = get_u64(p + 8);
+    p += 16;
+    if (runs > n || values_size > (size_t)(end - p) || (runs == 0) != (n == 0)) return false;
+    if (runs == 0) return true;
+
+    uint32_t* values = malloc(2 * runs * sizeof(uint32_t));
+    if (!values) return false;
+    uint32_t* lengths = values + runs;
+    bool ok = svb_decode(p, values_size, runs, values) == values_size &&
+              svb_decode(p + values_size, (size_t)(end - p) - values_size, runs, lengths) != 0;
+    size_t pos = 0;
+    for (size_t r = 0; ok && r < runs; r++) {
+        size_t len = (size_t)lengths[r] + 1;
+        if (len > n - pos) {
+            ok = false;
+            break;
+        }
+        int32_t v = (int32_t)((uint32_t)lo + values[r]);
+        for (size_t k = 0; k < len; k++) tokens[pos + k] = v;
+        pos += len;
+    }
+    free(values);
+    return ok && pos == n;
+}
+
+// --- Timestamp: each of the six components packed against its own minimum ---
+
+size_t codec_compress_timestamp(const int32_t* tokens, size_t num_rows, unsigned char* out) {
+    write_header(out, CODEC_TIMESTAMP, num_rows, num_rows * CODEC_TIMESTAMP_COLUMNS);
+    unsigned char* p = out + CODEC_HEADER_SIZE;
+    for (int c = 0; c < CODEC_TIMESTAMP_COLUMNS; c++) {
+        int32_t lo, hi;
+        min_max(tokens + c, num_rows, CODEC_TIMESTAMP_COLUMNS, &lo, &hi);
+        int width = bit_width((uint32_t)hi - (uint32_t)lo);
+        put_u32(p, (uint32_t)lo);
+        p[4] = (unsigned char)width;
+        p += 5;
+        p += bitpack(tokens + c, num_rows, CODEC_TIMESTAMP_COLUMNS, lo, width, p);
+    }
+    return (size_t)(p - out);
+}
+
+// Columns are unpacked a block of rows at a time into a contiguous buffer and
+// then interleaved, so the output is written once instead of once per column
+static bool decompress_timestamp(const unsigned char* p, const unsigned char* end, size_t n, int32_t* tokens) {
+    const unsigned char* data[CODEC_TIMESTAMP_COLUMNS];
+    size_t sizes[CODEC_TIMESTAMP_COLUMNS];
+    int32_t los[CODEC_TIMESTAMP_COLUMNS];
+    int widths[CODEC_TIMESTAMP_COLUMNS];
+    for (int c = 0; c < CODEC_TIMESTAMP_COLUMNS; c++) {
+        if (end - p < 5 || p[4] > 32) return false;
+        los[c] = (int32_t)get_u32(p);
+        widths[c] = p[4];
+        p += 5;
+        sizes[c] = packed_size(n, widths[c]);
+        if ((size_t)(end - p) < sizes[c]) return false;
+        data[c] = p;
+        p += sizes[c];
+    }
+    // A block of CODEC_UNPACK_BLOCK values always ends on a byte boundary
+    int32_t column[CODEC_UNPACK_BLOCK];
+    for (size_t start = 0; start < n; start += CODEC_UNPACK_BLOCK) {
+        size_t count = n - start < CODEC_UNPACK_BLOCK ? n - start : CODEC_UNPACK_BLOCK;
+        int32_t* rows = tokens + start * CODEC_TIMESTAMP_COLUMNS;
+        for (int c = 0; c < CODEC_TIMESTAMP_COLUMNS; c++) {
+            size_t skip = start * (size_t)widths[c] / 8;
+            bitunpack(data[c] + skip, sizes[c] - skip, count, los[c], widths[c], column);
+            for (size_t i = 0; i < count; i++) rows[i * CODEC_TIMESTAMP_COLUMNS + c] = column[i];
+        }
+    }
+    return true;
+}
+
+// --- Binary: row lengths, then each row as deltas from the previous token ---
+
+size_t codec_compress_binary(const int32_t* tokens, const uint32_t* counts, size_t num_rows, unsigned char* out) {
+    size_t num_tokens = 0;
+    for (size_t i = 0; i < num_rows; i++) num_tokens += counts[i];
+    write_header(out, CODEC_BINARY, num_rows, num_tokens);
+    unsigned char* p = out + CODEC_HEADER_SIZE;
+    int32_t lo, hi;
+    min_max(tokens, num_tokens, 1, &lo, &hi);
+    put_u32(p, (uint32_t)lo);
+    p += 12;
+
+    SvbWriter w;
+    svb_writer_init(&w, p, num_rows);
+    for (size_t i = 0; i < num_rows; i++) svb_put(&w, counts[i]);
+    size_t counts_size = svb_writer_size(&w, p);
+    put_u64(p - 8, counts_size);
+    p += counts_size;
+
+    // Rows are sorted, so deltas are small; wrapping keeps unsorted rows lossless
+    svb_writer_init(&w, p, num_tokens);
+    const int32_t* t = tokens;
+    for (size_t i = 0; i < num_rows; i++) {
+        uint32_t prev = (uint32_t)lo;
+        for (uint32_t k = 0; k < counts[i]; k++, t++) {
+            svb_put(&w, (uint32_t)*t - prev);
+            prev = (uint32_t)*t;
+        }
+    }
+    return (size_t)(p - out) + svb_writer_size(&w, p);
+}
+
+static bool decompress_binary(const unsigned char* p, const unsigned char* end, size_t num_rows,
+                              size_t num_tokens, int32_t* tokens, uint32_t* counts) {
+    if (end - p < 12) return false;
+    uint32_t lo = get_u32(p);
+    size_t counts_size = get_u64(p + 4);
+    p += 12;
+    if (counts_size > (size_t)(end - p)) return false;
+    if (num_rows && svb_decode(p, counts_size, num_rows, counts) != counts_size) return false;
+    p += counts_size;
+
+    size_t total = 0;
+    for (size_t i = 0; i < num_rows; i++) total += counts[i];
+    if (total != num_tokens) return false;
+    if (num_tokens && svb_decode(p, (size_t)(end - p), num_tokens, (uint32_t*)tokens) == 0) return false;
+
+    // Prefix sums restart at the base of every row
+    uint32_t* d = (uint32_t*)tokens;
+    for (size_t i = 0; i < num_rows; i++) {
+        uint32_t prev = lo;
+        for (uint32_t k = 0; k < counts[i]; k++, d++) {
+            prev += *d;
+            *d = prev;
+        }
+    }
+    return true;
+}
+
+bool codec_decompress(const unsigned char* in, size_t size, int32_t* tokens, uint32_t* counts) {
+    CodecInfo info;
+    if (!codec_info(in, size, &info)) return false;
+    const unsigned char* p = in + CODEC_HEADER_SIZE;
+    const unsigned char* end = in + size;
+    switch (info.layout) {
+        case CODEC_CATEGORY:
+            return decompress_category(p, end, info.num_rows, tokens);
+        case CODEC_TIMESTAMP:
+            return decompress_timestamp(p, end, info.num_rows, tokens);
+        case CODEC_BINARY:
+            return decompress_binary(p, end, info.num_rows, info.num_tokens, tokens, counts);
+    }
+    return false;
+}
@@ -0,0 +1,46 @@
+#ifndef TOKEN_CODEC_H
+#define TOKEN_CODEC_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Layout-aware compression of token streams produced by the tokenizers:
+// - category:  run-length encoding (values and run lengths in StreamVByte)
+//              or frame-of-reference bit-packing, whichever is smaller
+// - binary:    per-row counts plus delta-coded sorted positions, StreamVByte
+// - timestamp: per-component frame-of-reference bit-packing of the 6 columns
+// StreamVByte decoding uses SSSE3 shuffles when the CPU supports them.
+
+typedef enum {
+    CODEC_CATEGORY = 1,
+    CODEC_BINARY = 2,
+    CODEC_TIMESTAMP = 3
+} CodecLayout;
+
+typedef struct {
+    CodecLayout layout;
+    size_t num_rows;
+    size_t num_tokens;
+} CodecInfo;
+
+// Upper bound on the compressed size of num_tokens tokens in num_rows rows
+size_t codec_bound(size_t num_tokens, size_t num_rows);
+
+// One token per row; returns bytes written
+size_t codec_compress_category(const int32_t* tokens, size_t num_rows, unsigned char* out);
+
+// Row-major num_rows x 6 tokens; returns bytes written
+size_t codec_compress_timestamp(const int32_t* tokens, size_t num_rows, unsigned char* out);
+
+// Rows of strictly increasing tokens, concatenated, with counts[i] tokens in row i
+size_t codec_compress_binary(const int32_t* tokens, const uint32_t* counts, size_t num_rows, unsigned char* out);
+
+// Read and check the header of a compressed stream
+bool codec_info(const unsigned char* in, size_t size, CodecInfo* info);
+
+// Decompress into tokens (info.num_tokens entries) and, for the binary layout,
+// counts (info.num_rows entries). False on malformed input.
+bool codec_decompress(const unsigned char* in, size_t size, int32_t* tokens, uint32_t* counts);
+
+#endif
@@ -0,0 +1,196 @@
+#include "dedup.h"
+#include "hash.h"
+#include "sketch.h"
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define DEDUP_MIN_ROWS 1024
+#define DEDUP_SAMPLE 4096
+#define DEDUP_MIN_REPEATS 4     // average occurrences per distinct value to pay off
+
+typedef bool (*DedupEqual)(const void* ctx, size_t a, size_t b);
+
+// Open addressing table of group id + 1, grown to keep the load under 1/2
+typedef struct {
+    size_t* slots;
+    size_t mask;
+    uint64_t* hashes;   // hash of each group, for rehashing
+    size_t num_groups;
+    size_t capacity;
+} DedupTable;
+
+static bool table_init(DedupTable* t) {
+    t->mask = 1023;
+    t->slots = calloc(t->mask + 1, sizeof(size_t));
+    t->capacity = 512;
+    t->hashes = malloc(t->capacity * sizeof(uint64_t));
+    t->num_groups = 0;
+    return t->slots && t->hashes;
+}
+
+static void table_free(DedupTable* t) {
+    free(t->slots);
+    free(t->hashes);
+}
+
+static bool table_grow(DedupTable* t) {
+    size_t mask = 2 * t->mask + 1;
+    size_t* slots = calloc(mask + 1, sizeof(size_t));
+    uint64_t* hashes = realloc(t->hashes, 2 * t->capacity * sizeof(uint64_t));
+    if (!slots || !hashes) {
+        free(slots);
+        if (hashes) t->hashes = hashes;
+        return false;
+    }
+    for (size_t g = 0; g < t->num_groups; g++) {
+        size_t s = hashes[g] & mask;
+        while (slots[s]) s = (s + 1) & mask;
+        slots[s] = g + 1;
+    }
+    free(t->slots);
+    t->slots = slots;
+    t->mask = mask;
+    t->hashes = hashes;
+    t->capacity *= 2;
+    return true;
+}
+
+// Group id of row i, adding a new group if no earlier row is equal (SIZE_MAX on failure)
+static size_t table_group(DedupTable* t, uint64_t hash, size_t i, size_t* first,
+                          DedupEqual equal, const void* ctx) {
+    size_t s = hash & t->mask;
+    while (t->slots[s]) {
+        size_t g = t->slots[s] - 1;
+        if (t->hashes[g] == hash && equal(ctx, first[g], i)) return g;
+        s = (s + 1) & t->mask;
+    }
+    if (t->num_groups == t->capacity) {
+        if (!table_grow(t)) return SIZE_MAX;
+        s = hash & t->mask;
+        while (t->slots[s]) s = (s + 1) & t->mask;
+    }
+    size_t g = t->num_groups++;
+    t->hashes[g] = hash;
+    t->slots[s] = g + 1;
+    first[g] = i;
+    return g;
+}
+
+// Bit pattern with every NaN and both zeros folded together
+static inline uint64_t double_key(double v) {
+    if (isnan(v)) v = NAN;
+    if (v == 0.0) v = 0.0;
+    uint64_t bits;
+    memcpy(&bits, &v, 8);
+    return bits;
+}
+
+static bool doubles_equal(const void* ctx, size_t a, size_t b) {
+    const double* values = ctx;
+    return double_key(values[a]) == double_key(values[b]);
+}
+
+size_t dedup_doubles(const double* values, size_t n, size_t* ids, size_t* first) {
+    DedupTable t;
+    if (!table_init(&t)) {
+        table_free(&t);
+        return 0;
+    }
+    for (size_t i = 0; i < n; i++) {
+        // Runs of equal values (sorted or clustered input) skip the table
+        if (i > 0 && double_key(values[i]) == double_key(values[i - 1])) {
+            ids[i] = ids[i - 1];
+            continue;
+        }
+        size_t g = table_group(&t, hash_mix(double_key(values[i])), i, first, doubles_equal, values);
+        if (g == SIZE_MAX) {
+            table_free(&t);
+            return 0;
+        }
+        ids[i] = g;
+    }
+    size_t groups = t.num_groups;
+    table_free(&t);
+    return groups;
+}
+
+typedef struct {
+    const char* const* keys;
+    const size_t* lengths;
+} StringKeys;
+
+static bool strings_equal(const void* ctx, size_t a, size_t b) {
+    const StringKeys* s = ctx;
+    return s->lengths[a] == s->lengths[b] && memcmp(s->keys[a], s->keys[b], s->lengths[a]) == 0;
+}
+
+size_t dedup_strings(const char* const* keys, const size_t* lengths, size_t n, size_t* ids, size_t* first) {
+    DedupTable t;
+    if (!table_init(&t)) {
+        table_free(&t);
+        return 0;
+    }
+    StringKeys ctx = {keys, lengths};
+    for (size_t i = 0; i < n; i++) {
+        if (i > 0 && strings_equal(&ctx, i - 1, i)) {
+            ids[i] = ids[i - 1];
+            continue;
+        }
+        size_t g = table_group(&t, hash_bytes(keys[i], lengths[i]), i, first, strings_equal, &ctx);
+        if (g == SIZE_MAX) {
+            table_free(&t);
+            return 0;
+        }
+        ids[i] = g;
+    }
+    size_t groups = t.num_groups;
+    table_free(&t);
+    return groups;
+}
+
+static inline size_t sample_step(size_t n) {
+    return n > DEDUP_SAMPLE ? n / DEDUP_SAMPLE : 1;
+}
+
+// Distinct values D in the column that would show d distinct in a sample of s,
+// if all values were equally frequent: solves D * (1 - exp(-s / D)) = d
+static double column_cardinality(double d, double s) {
+    if (d >= 0.99 * s) return INFINITY;
+    double lo = d, hi = d;
+    while (hi * -expm1(-s / hi) < d) hi *= 2.0;
+    for (int i = 0; i < 50; i++) {
+        double mid = 0.5 * (lo + hi);
+        if (mid * -expm1(-s / mid) < d) lo = mid;
+        else hi = mid;
+    }
+    return hi;
+}
+
+static inline bool sample_worthwhile(const HyperLogLog* h, size_t sampled, size_t n) {
+    double distinct = column_cardinality(hll_estimate(h), (double)sampled);
+    return distinct * DEDUP_MIN_REPEATS <= (double)n;
+}
+
+bool dedup_doubles_worthwhile(const double* values, size_t n) {
+    if (n < DEDUP_MIN_ROWS) return false;
+    HyperLogLog h;
+    hll_init(&h);
+    size_t step = sample_step(n), sampled = 0;
+    for (size_t i = 0; i < n && sampled < DEDUP_SAMPLE; i += step, sampled++) {
+        hll_add(&h, hash_mix(double_key(values[i])));
+    }
+    return sample_worthwhile(&h, sampled, n);
+}
+
+bool dedup_strings_worthwhile(const char* const* keys, const size_t* lengths, size_t n) {
+    if (n < DEDUP_MIN_ROWS) return false;
+    HyperLogLog h;
+    hll_init(&h);
+    size_t step = sample_step(n), sampled = 0;
+    for (size_t i = 0; i < n && sampled < DEDUP_SAMPLE; i += step, sampled++) {
+        hll_add(&h, hash_bytes(keys[i], lengths[i]));
+    }
+    return sample_worthwhile(&h, sampled, n);
+}
@@ -0,0 +1,28 @@
+#ifndef DEDUP_H
+#define DEDUP_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// Whether batch encoders group equal inputs and encode each distinct one once
+typedef enum {
+    DEDUP_OFF = 0,
+    DEDUP_ON = 1,
+    DEDUP_AUTO = 2      // on when a sampled cardinality estimate says it pays off
+} DedupMode;
+
+// Group equal doubles (all NaNs are equal, and -0.0 equals 0.0). ids[i] is the
+// group of values[i] and first[g] the first row of group g. Returns the number
+// of groups, or 0 on allocation failure.
+size_t dedup_doubles(const double* values, size_t n, size_t* ids, size_t* first);
+
+// Group equal byte strings, as dedup_doubles
+size_t dedup_strings(const char* const* keys, const size_t* lengths, size_t n, size_t* ids, size_t* first);
+
+// Estimate from a strided sample whether grouping n values is worth it
+bool dedup_doubles_worthwhile(const double* values, size_t n);
+
+// Estimate from a strided sample whether grouping n strings is worth it
+bool dedup_strings_worthwhile(const char* const* keys, const size_t* lengths, size_t n);
+
+#endif
@@ -0,0 +1,19 @@
+#include "embed.h"
+
+void embed_finish(float* out, size_t dim, int count, EmbedPooling pooling) {
+    if (pooling != EMBED_MEAN || count <= 1) return;
+    const float scale = 1.0f / (float)count;
+    for (size_t i = 0; i < dim; i++) out[i] *= scale;
+}
+
+void embed_tokens(const float* table, size_t num_rows, size_t dim, const int* tokens, int count,
+                  float* out, EmbedPooling pooling) {
+    memset(out, 0, dim * sizeof(float));
+    int used = 0;
+    for (int i = 0; i < count; i++) {
+        if (tokens[i] < 0 || (size_t)tokens[i] >= num_rows) continue;
+        embed_add(out, table + (size_t)tokens[i] * dim, dim);
+        used++;
+    }
+    embed_finish(out, dim, used, pooling);
+}
@@ -0,0 +1,35 @@
+#ifndef EMBEDDING_BAG_H
+#define EMBEDDING_BAG_H
+
+#include <stddef.h>
+#include <string.h>
+
+// How the embedding rows of a value's tokens are combined
+typedef enum {
+    EMBED_SUM = 0,
+    EMBED_MEAN = 1      // sum divided by the number of tokens (zeros if none)
+} EmbedPooling;
+
+typedef float f32x8 __attribute__((vector_size(32)));
+
+// out += row over dim floats, eight lanes at a time
+static inline void embed_add(float* restrict out, const float* restrict row, size_t dim) {
+    size_t i = 0;
+    for (; i + 8 <= dim; i += 8) {
+        f32x8 a, b;
+        memcpy(&a, out + i, sizeof(a));
+        memcpy(&b, row + i, sizeof(b));
+        a += b;
+        memcpy(out + i, &a, sizeof(a));
+    }
+    for (; i < dim; i++) out[i] += row[i];
+}
+
+// Apply pooling to a row accumulated from count tokens
+void embed_finish(float* out, size_t dim, int count, EmbedPooling pooling);
+
+// Pool the table rows of count tokens into out (tokens outside the table add nothing)
+void embed_tokens(const float* table, size_t num_rows, size_t dim, const int* tokens, int count,
+                  float* out, EmbedPooling pooling);
+
+#endif
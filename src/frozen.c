@@ -0,0 +1,227 @@
+#include "frozen.h"
+#include "hash.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define FROZEN_MAGIC "ZFMP"
+#define FROZEN_VERSION 1
+#define FROZEN_KEYS_PER_BUCKET 5
+#define FROZEN_MAX_ATTEMPTS 16
+
+typedef struct {
+    char magic[4];
+    uint32_t version;
+    uint64_t num_keys;
+    uint64_t num_buckets;
+    uint64_t seed;
+    int32_t offset;
+    uint32_t reserved;
+} FrozenHeader;
+
+typedef struct {
+    uint32_t fingerprint;
+    uint32_t id;
+} FrozenEntry;
+
+static inline size_t align8(size_t n) {
+    return (n + 7) & ~(size_t)7;
+}
+
+static inline uint64_t fast_range(uint64_t x, uint64_t n) {
+    return (uint64_t)(((unsigned __int128)x * n) >> 64);
+}
+
+static inline uint64_t key_hash(const char* key, size_t len, uint64_t seed) {
+    return hash_mix(hash_bytes(key, len) ^ seed);
+}
+
+// Skewed bucket assignment: 60% of the keys share 30% of the buckets
+static inline uint64_t bucket_of(uint64_t h, uint64_t num_buckets) {
+    if (num_buckets < 2) return 0;
+    uint64_t g = hash_mix(h ^ 0xc2b2ae3d27d4eb4fULL);
+    uint64_t dense = num_buckets * 3 / 10 ? num_buckets * 3 / 10 : 1;
+    if ((uint32_t)g < (uint32_t)(0.6 * 4294967296.0)) return fast_range(g, dense);
+    return dense + fast_range(g, num_buckets - dense);
+}
+
+static inline uint64_t position_of(uint64_t h, uint32_t pilot, uint64_t n) {
+    return fast_range(hash_mix(h ^ hash_mix((uint64_t)pilot + 0x9e3779b97f4a7c15ULL)), n);
+}
+
+typedef struct {
+    uint64_t bucket;
+    uint64_t hash;
+    uint32_t id;
+} FrozenKey;
+
+static int compare_keys(const void* a, const void* b) {
+    const FrozenKey* x = a;
+    const FrozenKey* y = b;
+    if (x->bucket != y->bucket) return x->bucket < y->bucket ? -1 : 1;
+    return (x->hash > y->hash) - (x->hash < y->hash);
+}
+
+typedef struct {
+    uint64_t start;
+    uint64_t size;
+} FrozenBucket;
+
+static int compare_buckets(const void* a, const void* b) {
+    const FrozenBucket* x = a;
+    const FrozenBucket* y = b;
+    if (x->size != y->size) return x->size > y->size ? -1 : 1;
+    return (x->start > y->start) - (x->start < y->start);
+}
+
+// Find a pilot for every bucket, largest buckets first (false to retry with another seed)
+static bool place_keys(FrozenKey* keys, uint64_t n, uint64_t num_buckets,
+                       uint32_t* pilots, FrozenEntry* entries, uint8_t* taken) {
+    qsort(keys, n, sizeof(FrozenKey), compare_keys);
+    FrozenBucket* buckets = malloc(num_buckets * sizeof(FrozenBucket));
+    uint64_t* positions = malloc(n * sizeof(uint64_t));
+    if (!buckets || !positions) {
+        free(buckets);
+        free(positions);
+        return false;
+    }
+    uint64_t count = 0;
+    for (uint64_t i = 0; i < n;) {
+        uint64_t j = i;
+        while (j < n && keys[j].bucket == keys[i].bucket) {
+            // Equal hashes in one bucket can never be separated
+            if (j > i && keys[j].hash == keys[j - 1].hash) {
+                free(buckets);
+                free(positions);
+                return false;
+            }
+            j++;
+        }
+        buckets[count++] = (FrozenBucket){i, j - i};
+        i = j;
+    }
+    qsort(buckets, count, sizeof(FrozenBucket), compare_buckets);
+
+    memset(pilots, 0, num_buckets * sizeof(uint32_t));
+    memset(taken, 0, n);
+    bool ok = true;
+    for (uint64_t b = 0; b < count && ok; b++) {
+        const FrozenKey* bucket = keys + buckets[b].start;
+        uint64_t size = buckets[b].size;
+        uint32_t pilot = 0;
+        for (;;) {
+            uint64_t k = 0;
+            for (; k < size; k++) {
+                uint64_t pos = position_of(bucket[k].hash, pilot, n);
+                if (taken[pos]) break;
+                taken[pos] = 1;
+                positions[k] = pos;
+            }
+            if (k == size) break;
+            while (k-- > 0) taken[positions[k]] = 0;
+            if (++pilot == UINT32_MAX) {
+                ok = false;
+                break;
+            }
+        }
+        if (!ok) break;
+        pilots[bucket[0].bucket] = pilot;
+        for (uint64_t k = 0; k < size; k++) {
+            entries[positions[k]].fingerprint = (uint32_t)bucket[k].hash;
+            entries[positions[k]].id = bucket[k].id;
+        }
+    }
+    free(buckets);
+    free(positions);
+    return ok;
+}
+
+bool category_freeze(const CategoryTokenizer* t, unsigned char** out, size_t* size) {
+    if (!t->fitted || t->num_categories == 0 || t->num_categories > UINT32_MAX) return false;
+    uint64_t n = t->num_categories;
+    uint64_t num_buckets = (n + FROZEN_KEYS_PER_BUCKET - 1) / FROZEN_KEYS_PER_BUCKET;
+    size_t pilots_size = align8(num_buckets * sizeof(uint32_t));
+    size_t total = sizeof(FrozenHeader) + pilots_size + n * sizeof(FrozenEntry);
+
+    unsigned char* buffer = calloc(1, total);
+    FrozenKey* keys = malloc(n * sizeof(FrozenKey));
+    uint8_t* taken = malloc(n);
+    if (!buffer || !keys || !taken) {
+        free(buffer);
+        free(keys);
+        free(taken);
+        return false;
+    }
+    uint32_t* pilots = (uint32_t*)(buffer + sizeof(FrozenHeader));
+    FrozenEntry* entries = (FrozenEntry*)(buffer + sizeof(FrozenHeader) + pilots_size);
+
+    bool ok = false;
+    uint64_t seed = 0x5bd1e995ULL;
+    for (int attempt = 0; attempt < FROZEN_MAX_ATTEMPTS && !ok; attempt++) {
+        seed = hash_mix(seed + attempt);
+        for (uint64_t i = 0; i < n; i++) {
+            const char* key = t->categories[i];
+            keys[i].hash = key_hash(key, strlen(key), seed);
+            keys[i].bucket = bucket_of(keys[i].hash, num_buckets);
+            keys[i].id = (uint32_t)i;
+        }
+        ok = place_keys(keys, n, num_buckets, pilots, entries, taken);
+    }
+    free(keys);
+    free(taken);
+    if (!ok) {
+        free(buffer);
+        return false;
+    }
+
+    FrozenHeader header = {{0}, FROZEN_VERSION, n, num_buckets, seed, t->offset, 0};
+    memcpy(header.magic, FROZEN_MAGIC, 4);
+    memcpy(buffer, &header, sizeof(header));
+    *out = buffer;
+    *size = total;
+    return true;
+}
+
+bool frozen_validate(const void* data, size_t size) {
+    FrozenHeader header;
+    if (size < sizeof(header)) return false;
+    memcpy(&header, data, sizeof(header));
+    if (memcmp(header.magic, FROZEN_MAGIC, 4) != 0 || header.version != FROZEN_VERSION) return false;
+    if (header.num_keys == 0 || header.num_keys > UINT32_MAX) return false;
+    if (header.num_buckets != (header.num_keys + FROZEN_KEYS_PER_BUCKET - 1) / FROZEN_KEYS_PER_BUCKET) return false;
+    size_t expected = sizeof(header) + align8(header.num_buckets * sizeof(uint32_t)) +
+                      header.num_keys * sizeof(FrozenEntry);
+    return size == expected;
+}
+
+size_t frozen_num_categories(const void* data) {
+    FrozenHeader header;
+    memcpy(&header, data, sizeof(header));
+    return header.num_keys;
+}
+
+int frozen_offset(const void* data) {
+    FrozenHeader header;
+    memcpy(&header, data, sizeof(header));
+    return header.offset;
+}
+
+int frozen_encode(const void* data, const char* value) {
+    const unsigned char* base = data;
+    FrozenHeader header;
+    memcpy(&header, base, sizeof(header));
+    size_t len = value ? strlen(value) : 0;
+    if (len == 0) return header.offset;  // Missing value
+
+    uint64_t h = key_hash(value, len, header.seed);
+
+    // One pilot read, then one entry read
+    uint32_t pilot;
+    memcpy(&pilot, base + sizeof(header) + bucket_of(h, header.num_buckets) * sizeof(uint32_t), sizeof(pilot));
+    FrozenEntry entry;
+    memcpy(&entry, base + sizeof(header) + align8(header.num_buckets * sizeof(uint32_t)) +
+                   position_of(h, pilot, header.num_keys) * sizeof(FrozenEntry), sizeof(entry));
+
+    if (entry.fingerprint != (uint32_t)h) return 1;  // Unknown category
+    return (int)entry.id + 2 + header.offset;
+}
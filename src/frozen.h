@@ -0,0 +1,29 @@
+#ifndef FROZEN_VOCABULARY_H
+#define FROZEN_VOCABULARY_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "category.h"
+
+// Immutable encode-only artifact of a fitted CategoryTokenizer: a minimal
+// perfect hash (PTHash-style pilots, ~6.4 bits per key) plus one entry per key
+// holding a 32-bit fingerprint and the token id. The buffer holds no pointers,
+// so it can be written to disk and used straight from an mmap.
+
+// Compile the fitted vocabulary into a newly malloc'd buffer
+bool category_freeze(const CategoryTokenizer* t, unsigned char** out, size_t* size);
+
+// Check that a buffer holds a well-formed artifact
+bool frozen_validate(const void* data, size_t size);
+
+// Number of categories in the artifact
+size_t frozen_num_categories(const void* data);
+
+// Token offset of the source tokenizer (also the missing token)
+int frozen_offset(const void* data);
+
+// Encode value into tokens (same ids as category_encode; unknowns whose
+// fingerprint collides are misreported with probability 2^-32)
+int frozen_encode(const void* data, const char* value);
+
+#endif
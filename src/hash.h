@@ -0,0 +1,40 @@
+#ifndef ZF_HASH_H
+#define ZF_HASH_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+// Final avalanche step (splitmix64)
+static inline uint64_t hash_mix(uint64_t x) {
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return x;
+}
+
+// Hash a byte range, consuming 8 bytes per step
+static inline uint64_t hash_bytes(const void* data, size_t len) {
+    const unsigned char* p = (const unsigned char*)data;
+    uint64_t h = 0x9e3779b97f4a7c15ULL ^ (len * 0xff51afd7ed558ccdULL);
+    while (len >= 8) {
+        uint64_t w;
+        memcpy(&w, p, 8);
+        h = (h ^ hash_mix(w)) * 0x9e3779b97f4a7c15ULL;
+        p += 8;
+        len -= 8;
+    }
+    uint64_t tail = 0;
+    memcpy(&tail, p, len);
+    h ^= hash_mix(tail ^ ((uint64_t)len << 56));
+    return hash_mix(h);
+}
+
+// Hash a NUL-terminated string
+static inline uint64_t hash_string(const char* s) {
+    return hash_bytes(s, strlen(s));
+}
+
+#endif
@@ -0,0 +1,122 @@
+#include "histogram.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define HISTOGRAM_LANES 4                   // private count arrays for repeated tokens
+#define HISTOGRAM_LANES_MAX_BINS (1 << 16)  // beyond this one lane stays in cache better
+#define HISTOGRAM_CHUNK ((size_t)1 << 31)   // tokens per private count (fits uint32)
+
+bool histogram_init(TokenHistogram* h, size_t num_tokens) {
+    h->num_tokens = num_tokens;
+    h->counts = calloc(num_tokens + 1, sizeof(uint64_t));
+    return h->counts != NULL;
+}
+
+void histogram_free(TokenHistogram* h) {
+    free(h->counts);
+    h->counts = NULL;
+}
+
+static size_t histogram_lanes(const TokenHistogram* h, size_t n) {
+    size_t bins = h->num_tokens + 1;
+    return (bins <= HISTOGRAM_LANES_MAX_BINS && n >= HISTOGRAM_LANES * bins) ? HISTOGRAM_LANES : 1;
+}
+
+size_t histogram_work_size(const TokenHistogram* h, size_t n) {
+    size_t bins = h->num_tokens + 1;
+    // Clearing and flushing private counts only pays off once a batch covers them
+    if (n < bins / 2) return 0;
+    return histogram_lanes(h, n) * bins * sizeof(uint32_t);
+}
+
+// Bin of a token: itself if in range, the overflow bin otherwise
+static inline size_t histogram_bin(int32_t token, uint32_t num_tokens) {
+    return (uint32_t)token < num_tokens ? (uint32_t)token : num_tokens;
+}
+
+void histogram_add(TokenHistogram* h, const int32_t* tokens, size_t n, void* work) {
+    const size_t bins = h->num_tokens + 1;
+    const uint32_t num_tokens = (uint32_t)h->num_tokens;
+
+    if (histogram_work_size(h, n) == 0) {
+        for (size_t i = 0; i < n; i++)
+            __atomic_fetch_add(&h->counts[histogram_bin(tokens[i], num_tokens)], 1, __ATOMIC_RELAXED);
+        return;
+    }
+
+    const size_t lanes = histogram_lanes(h, n);
+    uint32_t* local = work;
+    for (size_t start = 0; start < n; start += HISTOGRAM_CHUNK) {
+        size_t end = n - start < HISTOGRAM_CHUNK ? n : start + HISTOGRAM_CHUNK;
+        memset(local, 0, lanes * bins * sizeof(uint32_t));
+
+        size_t i = start;
+        if (lanes == HISTOGRAM_LANES) {
+            // Consecutive equal tokens land in different arrays, so the increments
+            // do not wait on each other's stores
+            uint32_t* l0 = local;
+            uint32_t* l1 = local + bins;
+            uint32_t* l2 = local + 2 * bins;
+            uint32_t* l3 = local + 3 * bins;
+            for (; i + 4 <= end; i += 4) {
+                l0[histogram_bin(tokens[i], num_tokens)]++;
+                l1[histogram_bin(tokens[i + 1], num_tokens)]++;
+                l2[histogram_bin(tokens[i + 2], num_tokens)]++;
+                l3[histogram_bin(tokens[i + 3], num_tokens)]++;
+            }
+        }
+        for (; i < end; i++) local[histogram_bin(tokens[i], num_tokens)]++;
+
+        for (size_t b = 0; b < bins; b++) {
+            uint64_t count = 0;
+            for (size_t l = 0; l < lanes; l++) count += local[l * bins + b];
+            if (count) __atomic_fetch_add(&h->counts[b], count, __ATOMIC_RELAXED);
+        }
+    }
+}
+
+void histogram_read(const TokenHistogram* h, uint64_t* out) {
+    for (size_t b = 0; b <= h->num_tokens; b++) out[b] = __atomic_load_n(&h->counts[b], __ATOMIC_RELAXED);
+}
+
+void histogram_clear(TokenHistogram* h) {
+    for (size_t b = 0; b <= h->num_tokens; b++) __atomic_store_n(&h->counts[b], 0, __ATOMIC_RELAXED);
+}
+
+double histogram_divergence(const uint64_t* actual, const uint64_t* reference, size_t num_tokens,
+                            DivergenceKind kind, double eps) {
+    uint64_t actual_total = 0;
+    uint64_t reference_total = 0;
+    for (size_t b = 0; b < num_tokens; b++) {
+        actual_total += actual[b];
+        reference_total += reference[b];
+    }
+    if (actual_total == 0 || reference_total == 0) return NAN;
+
+    const double actual_scale = 1.0 / (double)actual_total;
+    const double reference_scale = 1.0 / (double)reference_total;
+    double sum = 0.0;
+    for (size_t b = 0; b < num_tokens; b++) {
+        if (actual[b] == 0 && reference[b] == 0) continue;
+        double p = (double)actual[b] * actual_scale;
+        double q = (double)reference[b] * reference_scale;
+        switch (kind) {
+            case DIVERGENCE_PSI:
+                p = fmax(p, eps);
+                q = fmax(q, eps);
+                sum += (p - q) * log(p / q);
+                break;
+            case DIVERGENCE_KL:
+                if (p > 0.0) sum += p * log(p / fmax(q, eps));
+                break;
+            case DIVERGENCE_JS: {
+                double m = 0.5 * (p + q);
+                if (p > 0.0) sum += 0.5 * p * log(p / m);
+                if (q > 0.0) sum += 0.5 * q * log(q / m);
+                break;
+            }
+        }
+    }
+    return sum;
+}
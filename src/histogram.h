@@ -0,0 +1,47 @@
+#ifndef TOKEN_HISTOGRAM_H
+#define TOKEN_HISTOGRAM_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Token counts shared by concurrent writers. Writers count a batch privately and
+// then flush it with relaxed atomic adds, so no lock is taken and readers see
+// each batch either not at all or bin by bin as it lands.
+typedef struct __attribute__((aligned(8))) {
+    uint64_t* counts;       // num_tokens bins followed by one overflow bin
+    size_t num_tokens;
+} TokenHistogram;
+
+typedef enum {
+    DIVERGENCE_PSI = 0,     // population stability index
+    DIVERGENCE_KL = 1,      // Kullback-Leibler divergence KL(actual || reference)
+    DIVERGENCE_JS = 2       // Jensen-Shannon divergence (nats, at most ln 2)
+} DivergenceKind;
+
+// Allocate zeroed counts for tokens 0..num_tokens-1 (false on allocation failure)
+bool histogram_init(TokenHistogram* h, size_t num_tokens);
+
+// Free the counts
+void histogram_free(TokenHistogram* h);
+
+// Bytes of work memory histogram_add wants for a batch of n tokens
+// (0 means the batch is small enough to add directly)
+size_t histogram_work_size(const TokenHistogram* h, size_t n);
+
+// Count n tokens; tokens outside 0..num_tokens-1 go to the overflow bin.
+// work must hold histogram_work_size(h, n) bytes (16-byte aligned).
+void histogram_add(TokenHistogram* h, const int32_t* tokens, size_t n, void* work);
+
+// Copy the current counts (num_tokens + 1 values, overflow last)
+void histogram_read(const TokenHistogram* h, uint64_t* out);
+
+// Zero all counts
+void histogram_clear(TokenHistogram* h);
+
+// Divergence of actual from reference counts over num_tokens bins (overflow
+// excluded). PSI and KL floor empty bins at proportion eps. NaN if either is empty.
+double histogram_divergence(const uint64_t* actual, const uint64_t* reference, size_t num_tokens,
+                            DivergenceKind kind, double eps);
+
+#endif
@@ -0,0 +1,50 @@
+#include "logits.h"
+#include <math.h>
+#include <string.h>
+
+typedef float f32x8 __attribute__((vector_size(32)));
+typedef int32_t i32x8 __attribute__((vector_size(32)));
+
+size_t logits_argmax(const float* values, size_t begin, size_t end) {
+    const float* v = values + begin;
+    size_t n = end - begin;
+    float best = -INFINITY;
+    size_t i = 0;
+    if (n >= 8) {
+        // Lane-wise maximum first; x > m is false for NaN, so NaNs are never taken
+        f32x8 m = {-INFINITY, -INFINITY, -INFINITY, -INFINITY, -INFINITY, -INFINITY, -INFINITY, -INFINITY};
+        for (; i + 8 <= n; i += 8) {
+            f32x8 x;
+            memcpy(&x, v + i, sizeof(x));
+            i32x8 greater = x > m;
+            m = (f32x8)((greater & (i32x8)x) | (~greater & (i32x8)m));
+        }
+        for (int lane = 0; lane < 8; lane++) {
+            if (m[lane] > best) best = m[lane];
+        }
+    }
+    for (; i < n; i++) {
+        if (v[i] > best) best = v[i];
+    }
+    // Then the first position holding it
+    for (i = 0; i < n; i++) {
+        if (v[i] == best) return begin + i;
+    }
+    return begin;
+}
+
+void logits_topk(const float* values, size_t begin, size_t end, size_t k, int32_t* out) {
+    size_t filled = 0;
+    for (size_t i = begin; i < end; i++) {
+        float x = values[i];
+        if (x != x) continue;
+        if (filled == k && !(x > values[out[k - 1]])) continue;
+        size_t j = filled < k ? filled++ : k - 1;
+        while (j > 0 && x > values[out[j - 1]]) {
+            out[j] = out[j - 1];
+            j--;
+        }
+        out[j] = (int32_t)i;
+    }
+    for (size_t j = filled; j < k; j++) out[j] = -1;
+}
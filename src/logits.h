@@ -0,0 +1,15 @@
+#ifndef LOGITS_DECODE_H
+#define LOGITS_DECODE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Index of the largest of values[begin..end), the first one on ties. NaNs never
+// win (begin if all are NaN).
+size_t logits_argmax(const float* values, size_t begin, size_t end);
+
+// Indices of the k largest of values[begin..end) in descending order, lower
+// index first on ties. NaNs are skipped; slots left unfilled are set to -1.
+void logits_topk(const float* values, size_t begin, size_t end, size_t k, int32_t* out);
+
+#endif
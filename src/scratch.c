@@ -0,0 +1,112 @@
+#include "scratch.h"
+#include <pthread.h>
+#include <stdlib.h>
+
+#define SCRATCH_MIN_BLOCK (64 * 1024)
+#define SCRATCH_ALIGN 16
+
+typedef struct ScratchBlock {
+    struct ScratchBlock* prev;
+    size_t size;
+    size_t used;
+    _Alignas(SCRATCH_ALIGN) unsigned char data[];
+} ScratchBlock;
+
+static __thread ScratchBlock* scratch_top = NULL;
+static pthread_key_t scratch_key;
+static pthread_once_t scratch_once = PTHREAD_ONCE_INIT;
+
+// Frees a thread's arena when the thread exits
+static void scratch_destroy(void* arg) {
+    ScratchBlock* block = arg;
+    while (block) {
+        ScratchBlock* prev = block->prev;
+        free(block);
+        block = prev;
+    }
+}
+
+static void scratch_key_init(void) {
+    pthread_key_create(&scratch_key, scratch_destroy);
+}
+
+static ScratchBlock* scratch_block_new(size_t size, ScratchBlock* prev) {
+    ScratchBlock* block = malloc(sizeof(ScratchBlock) + size);
+    if (!block) return NULL;
+    block->prev = prev;
+    block->size = size;
+    block->used = 0;
+    pthread_once(&scratch_once, scratch_key_init);
+    pthread_setspecific(scratch_key, block);
+    return block;
+}
+
+void* scratch_alloc(size_t size) {
+    size = (size + SCRATCH_ALIGN - 1) & ~(size_t)(SCRATCH_ALIGN - 1);
+    ScratchBlock* top = scratch_top;
+    if (!top || top->size - top->used < size) {
+        // Earlier borrows must stay valid, so chain a new block instead of growing
+        size_t block_size = top ? 2 * top->size : SCRATCH_MIN_BLOCK;
+        while (block_size < size) block_size *= 2;
+        top = scratch_block_new(block_size, top);
+        if (!top) return NULL;
+        scratch_top = top;
+    }
+    void* ptr = top->data + top->used;
+    top->used += size;
+    return ptr;
+}
+
+ScratchMark scratch_mark(void) {
+    ScratchMark mark = {scratch_top, scratch_top ? scratch_top->used : 0};
+    return mark;
+}
+
+void scratch_release_to(ScratchMark mark) {
+    ScratchBlock* top = scratch_top;
+    if (!top) return;
+    // Only the bottom block is ever empty, so a mark with nothing used means nothing
+    // stays borrowed; otherwise an outer call still holds buffers up to the mark
+    if (mark.used > 0) {
+        while (top != mark.block) {
+            ScratchBlock* prev = top->prev;
+            free(top);
+            top = prev;
+        }
+        top->used = mark.used;
+        scratch_top = top;
+        pthread_setspecific(scratch_key, top);
+        return;
+    }
+    if (!top->prev) {
+        top->used = 0;
+        return;
+    }
+    // Nothing borrowed any more: coalesce the chain into one block big enough for the whole call
+    size_t total = 0;
+    while (top) {
+        ScratchBlock* prev = top->prev;
+        total += top->size;
+        free(top);
+        top = prev;
+    }
+    scratch_top = scratch_block_new(total, NULL);
+    if (!scratch_top) pthread_setspecific(scratch_key, NULL);
+}
+
+size_t scratch_capacity(void) {
+    size_t total = 0;
+    for (ScratchBlock* block = scratch_top; block; block = block->prev) {
+        total += block->size;
+    }
+    return total;
+}
+
+bool scratch_release(void) {
+    if (!scratch_top) return true;
+    if (scratch_top->used > 0 || scratch_top->prev) return false;
+    scratch_destroy(scratch_top);
+    scratch_top = NULL;
+    pthread_setspecific(scratch_key, NULL);
+    return true;
+}
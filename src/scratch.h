@@ -0,0 +1,33 @@
+#ifndef SCRATCH_ARENA_H
+#define SCRATCH_ARENA_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// Per-thread bump allocator for temporary buffers sized by user input. A caller
+// takes a mark before borrowing and releases back to it when done, so a call that
+// re-enters the library (e.g. through __float__ or __index__) only returns its own
+// buffers. The arena keeps its capacity across calls, so steady-state calls do not malloc.
+
+// Position in the arena to release back to
+typedef struct {
+    struct ScratchBlock* block;
+    size_t used;
+} ScratchMark;
+
+// Borrow size bytes (16-byte aligned); NULL on allocation failure
+void* scratch_alloc(size_t size);
+
+// Current position of this thread's arena
+ScratchMark scratch_mark(void);
+
+// Return everything borrowed since the mark (marks are released in reverse order)
+void scratch_release_to(ScratchMark mark);
+
+// Bytes currently reserved by this thread's arena
+size_t scratch_capacity(void);
+
+// Free this thread's arena (false, keeping it, while anything is borrowed)
+bool scratch_release(void);
+
+#endif
@@ -0,0 +1,21 @@
+#include "sketch.h"
+#include <math.h>
+#include <string.h>
+
+void hll_init(HyperLogLog* h) {
+    memset(h->registers, 0, sizeof(h->registers));
+}
+
+double hll_estimate(const HyperLogLog* h) {
+    const double m = (double)(1 << HLL_PRECISION);
+    double sum = 0.0;
+    size_t zeros = 0;
+    for (size_t i = 0; i < (1 << HLL_PRECISION); i++) {
+        sum += ldexp(1.0, -h->registers[i]);
+        zeros += h->registers[i] == 0;
+    }
+    double estimate = 0.7213 / (1.0 + 1.079 / m) * m * m / sum;
+    // Linear counting is more accurate while many registers are still empty
+    if (estimate <= 2.5 * m && zeros > 0) estimate = m * log(m / (double)zeros);
+    return estimate;
+}
@@ -0,0 +1,28 @@
+#ifndef CARDINALITY_SKETCH_H
+#define CARDINALITY_SKETCH_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define HLL_PRECISION 10    // 1024 registers, ~3% standard error
+
+// HyperLogLog distinct count estimator over 64-bit hashes
+typedef struct __attribute__((aligned(8))) {
+    uint8_t registers[1 << HLL_PRECISION];
+} HyperLogLog;
+
+// Initialize an empty sketch
+void hll_init(HyperLogLog* h);
+
+// Add a key by its 64-bit hash
+static inline void hll_add(HyperLogLog* h, uint64_t hash) {
+    size_t index = hash >> (64 - HLL_PRECISION);
+    uint64_t rest = (hash << HLL_PRECISION) | (1ULL << (HLL_PRECISION - 1));
+    uint8_t rank = (uint8_t)(__builtin_clzll(rest) + 1);
+    if (rank > h->registers[index]) h->registers[index] = rank;
+}
+
+// Estimated number of distinct keys added
+double hll_estimate(const HyperLogLog* h);
+
+#endif
@@ -0,0 +1,233 @@
+#include "strsort.h"
+#include <pthread.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define STRSORT_INSERTION 16
+#define STRSORT_PARALLEL_MIN (1 << 15)
+#define STRSORT_MAX_THREADS 16
+
+typedef struct {
+    uint64_t word;      // 8 key bytes at the current depth (big endian)
+    uint64_t prefix;    // first 8 key bytes, kept for the merge passes
+    const char* key;
+    size_t len;
+    size_t index;
+} StrRecord;
+
+// Load 8 bytes at depth as a big endian word, zero padded past the end
+static inline uint64_t load_word(const char* key, size_t len, size_t depth) {
+    unsigned char buf[8] = {0};
+    if (depth < len) memcpy(buf, key + depth, len - depth < 8 ? len - depth : 8);
+    uint64_t w;
+    memcpy(&w, buf, 8);
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    w = __builtin_bswap64(w);
+#endif
+    return w;
+}
+
+// Full comparison of two records that agree on the first depth bytes
+static inline int compare_from(const StrRecord* a, const StrRecord* b, size_t depth) {
+    if (a->word != b->word) return a->word < b->word ? -1 : 1;
+    if (depth + 8 >= a->len || depth + 8 >= b->len) {
+        return (a->len > b->len) - (a->len < b->len);
+    }
+    return strcmp(a->key + depth + 8, b->key + depth + 8);
+}
+
+static void insertion_sort(StrRecord* a, size_t n, size_t depth) {
+    for (size_t i = 1; i < n; i++) {
+        StrRecord tmp = a[i];
+        size_t j = i;
+        while (j > 0 && compare_from(&tmp, &a[j - 1], depth) < 0) {
+            a[j] = a[j - 1];
+            j--;
+        }
+        a[j] = tmp;
+    }
+}
+
+static inline void swap_records(StrRecord* a, StrRecord* b) {
+    StrRecord tmp = *a;
+    *a = *b;
+    *b = tmp;
+}
+
+static inline uint64_t median3(uint64_t a, uint64_t b, uint64_t c) {
+    if (a < b) return b < c ? b : (a < c ? c : a);
+    return a < c ? a : (b < c ? c : b);
+}
+
+// Keys sharing a word continue on the next 8 bytes; returns the sub-range still to sort
+static StrRecord* advance_equal(StrRecord* a, size_t* n, size_t depth) {
+    size_t live = 0;
+    for (size_t k = 0; k < *n; k++) {
+        a[k].word = load_word(a[k].key, a[k].len, depth);
+        if (a[k].len > depth) live++;
+    }
+    // A key that ended here sorts first; keys are distinct so at most one did
+    if (live < *n) {
+        for (size_t k = 0; k < *n; k++) {
+            if (a[k].len <= depth) {
+                swap_records(&a[0], &a[k]);
+                break;
+            }
+        }
+        a++;
+        (*n)--;
+    }
+    return a;
+}
+
+// Multikey quicksort, comparing a whole 8-byte word per step. The two smaller
+// partitions are sorted recursively and the largest iteratively, which bounds
+// the stack depth by log2(n).
+static void mkqs(StrRecord* a, size_t n, size_t depth) {
+    while (n > 1) {
+        if (n <= STRSORT_INSERTION) {
+            insertion_sort(a, n, depth);
+            return;
+        }
+        uint64_t pivot = median3(a[0].word, a[n / 2].word, a[n - 1].word);
+
+        // Three-way partition: [0, lt) < pivot, [lt, gt) == pivot, [gt, n) > pivot
+        size_t lt = 0, i = 0, gt = n;
+        while (i < gt) {
+            if (a[i].word < pivot) {
+                swap_records(&a[lt++], &a[i++]);
+            } else if (a[i].word > pivot) {
+                swap_records(&a[i], &a[--gt]);
+            } else {
+                i++;
+            }
+        }
+
+        StrRecord* parts[3] = {a, a + lt, a + gt};
+        size_t sizes[3] = {lt, gt - lt, n - gt};
+        size_t depths[3] = {depth, depth + 8, depth};
+        parts[1] = advance_equal(parts[1], &sizes[1], depth + 8);
+
+        int largest = 0;
+        for (int p = 1; p < 3; p++) {
+            if (sizes[p] > sizes[largest]) largest = p;
+        }
+        for (int p = 0; p < 3; p++) {
+            if (p != largest) mkqs(parts[p], sizes[p], depths[p]);
+        }
+        a = parts[largest];
+        n = sizes[largest];
+        depth = depths[largest];
+    }
+}
+
+static inline int compare_records(const StrRecord* a, const StrRecord* b) {
+    if (a->prefix != b->prefix) return a->prefix < b->prefix ? -1 : 1;
+    if (a->len <= 8 || b->len <= 8) return (a->len > b->len) - (a->len < b->len);
+    return strcmp(a->key + 8, b->key + 8);
+}
+
+static void merge_runs(const StrRecord* a, size_t na, const StrRecord* b, size_t nb, StrRecord* out) {
+    size_t i = 0, j = 0, k = 0;
+    while (i < na && j < nb) {
+        out[k++] = compare_records(&b[j], &a[i]) < 0 ? b[j++] : a[i++];
+    }
+    memcpy(out + k, a + i, (na - i) * sizeof(StrRecord));
+    k += na - i;
+    memcpy(out + k, b + j, (nb - j) * sizeof(StrRecord));
+}
+
+typedef struct {
+    StrRecord* src;
+    StrRecord* dst;
+    size_t begin;
+    size_t mid;
+    size_t end;
+} SortTask;
+
+static void* sort_worker(void* arg) {
+    SortTask* task = (SortTask*)arg;
+    mkqs(task->src + task->begin, task->end - task->begin, 0);
+    return NULL;
+}
+
+static void* merge_worker(void* arg) {
+    SortTask* task = (SortTask*)arg;
+    merge_runs(task->src + task->begin, task->mid - task->begin,
+               task->src + task->mid, task->end - task->mid,
+               task->dst + task->begin);
+    return NULL;
+}
+
+// Run tasks on their own threads, falling back to the caller's thread
+static void run_tasks(void* (*worker)(void*), SortTask* tasks, size_t count) {
+    pthread_t threads[STRSORT_MAX_THREADS];
+    bool started[STRSORT_MAX_THREADS];
+    for (size_t i = 1; i < count; i++) {
+        started[i] = pthread_create(&threads[i], NULL, worker, &tasks[i]) == 0;
+        if (!started[i]) worker(&tasks[i]);
+    }
+    if (count > 0) worker(&tasks[0]);
+    for (size_t i = 1; i < count; i++) {
+        if (started[i]) pthread_join(threads[i], NULL);
+    }
+}
+
+static size_t sort_threads(size_t n) {
+    if (n < STRSORT_PARALLEL_MIN) return 1;
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    size_t threads = cpus > 0 ? (size_t)cpus : 1;
+    if (threads > STRSORT_MAX_THREADS) threads = STRSORT_MAX_THREADS;
+    while (threads > 1 && n / threads < STRSORT_PARALLEL_MIN / 4) threads--;
+    return threads;
+}
+
+bool strsort(const char* const* keys, const size_t* lengths, size_t n, size_t* order) {
+    if (n == 0) return true;
+    size_t threads = sort_threads(n);
+    StrRecord* records = malloc(n * sizeof(StrRecord));
+    StrRecord* scratch = threads > 1 ? malloc(n * sizeof(StrRecord)) : NULL;
+    if (!records || (threads > 1 && !scratch)) {
+        free(records);
+        free(scratch);
+        return false;
+    }
+    for (size_t i = 0; i < n; i++) {
+        records[i].key = keys[i];
+        records[i].len = lengths[i];
+        records[i].prefix = load_word(keys[i], lengths[i], 0);
+        records[i].word = records[i].prefix;
+        records[i].index = i;
+    }
+
+    // Sort equal chunks in parallel, then merge pairs of runs until one is left
+    SortTask tasks[STRSORT_MAX_THREADS];
+    size_t bounds[STRSORT_MAX_THREADS + 1];
+    for (size_t t = 0; t <= threads; t++) bounds[t] = n * t / threads;
+    for (size_t t = 0; t < threads; t++) {
+        tasks[t] = (SortTask){records, NULL, bounds[t], bounds[t + 1], bounds[t + 1]};
+    }
+    run_tasks(sort_worker, tasks, threads);
+
+    StrRecord* src = records;
+    StrRecord* dst = scratch;
+    for (size_t width = 1; width < threads; width *= 2) {
+        size_t count = 0;
+        for (size_t t = 0; t < threads; t += 2 * width) {
+            size_t mid = t + width < threads ? t + width : threads;
+            size_t end = t + 2 * width < threads ? t + 2 * width : threads;
+            tasks[count++] = (SortTask){src, dst, bounds[t], bounds[mid], bounds[end]};
+        }
+        run_tasks(merge_worker, tasks, count);
+        StrRecord* tmp = src;
+        src = dst;
+        dst = tmp;
+    }
+
+    for (size_t i = 0; i < n; i++) order[i] = src[i].index;
+    free(records);
+    free(scratch);
+    return true;
+}
@@ -0,0 +1,13 @@
+#ifndef STRSORT_H
+#define STRSORT_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// Sort n distinct NUL-terminated strings in strcmp order. Writes the sorted
+// permutation (indices into keys) to order. Large inputs are sorted with
+// multikey quicksort on cached 8-byte prefixes, one chunk per thread, and the
+// chunks merged in parallel. Returns false on allocation failure.
+bool strsort(const char* const* keys, const size_t* lengths, size_t n, size_t* order);
+
+#endif
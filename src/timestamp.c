@@ -1,4 +1,5 @@
 #include "timestamp.h"
+#include "logits.h"
 #include <ctype.h>
 #include <string.h>
 #include <stdlib.h>
@@ -30,6 +31,16 @@ void timestamp_init(TimestampTokenizer* t, int min_year, int max_year, int offse
     t->num_tokens = t->bucket_offsets[5] + 60 - offset;
 }
 
+// Whether year, month, day, hour, minute and second are in their token ranges
+static bool fields_in_range(const TimestampTokenizer* t, const int* f) {
+    return f[0] >= t->min_year && f[0] <= t->max_year &&
+           f[1] >= 1 && f[1] <= 12 &&
+           f[2] >= 1 && f[2] <= 31 &&
+           f[3] >= 0 && f[3] <= 23 &&
+           f[4] >= 0 && f[4] <= 59 &&
+           f[5] >= 0 && f[5] <= 60;  // 60 accounts for leap seconds
+}
+
 bool timestamp_parse(const TimestampTokenizer* t, const char* iso, struct tm* tm) {
     if (iso == NULL || tm == NULL) {
         return false;
@@ -76,12 +87,8 @@ bool timestamp_parse(const TimestampTokenizer* t, const char* iso, struct tm* tm
     }
     
     // Validate ranges
-    if (tm->tm_year < t->min_year || tm->tm_year > t->max_year ||
-        tm->tm_mon < 1 || tm->tm_mon > 12 ||
-        tm->tm_mday < 1 || tm->tm_mday > 31 ||
-        tm->tm_hour < 0 || tm->tm_hour > 23 ||
-        tm->tm_min < 0 || tm->tm_min > 59 ||
-        tm->tm_sec < 0 || tm->tm_sec > 60) {  // 60 accounts for leap seconds
+    const int fields[6] = {tm->tm_year, tm->tm_mon, tm->tm_mday, tm->tm_hour, tm->tm_min, tm->tm_sec};
+    if (!fields_in_range(t, fields)) {
         return false;
     }
     
@@ -96,10 +103,8 @@ bool timestamp_parse(const TimestampTokenizer* t, const char* iso, struct tm* tm
 void timestamp_encode(const TimestampTokenizer* t, const char* iso, int* tokens, int* count) {
     *count = 0;
     struct tm tm;
-    int last = 0;
 
     if (!timestamp_parse(t, iso, &tm)) {
-        printf("%s\n", iso);
         // Invalid format - mark all components as invalid
         *count = 6;
         tokens[0] = t->bucket_offsets[0];
@@ -125,8 +130,89 @@ void timestamp_encode(const TimestampTokenizer* t, const char* iso, int* tokens,
     tokens[(*count)++] = tm.tm_sec + t->bucket_offsets[5];
 }
 
+void timestamp_encode_fields(const TimestampTokenizer* t, const int* fields, int* tokens) {
+    if (!fields_in_range(t, fields)) {
+        for (int c = 0; c < 6; c++) tokens[c] = t->bucket_offsets[c];
+        return;
+    }
+    tokens[0] = (fields[0] - t->min_year) + t->bucket_offsets[0];
+    for (int c = 1; c < 6; c++) tokens[c] = fields[c] + t->bucket_offsets[c];
+}
+
+void timestamp_encode_missing(const TimestampTokenizer* t, int* tokens) {
+    for (int c = 0; c < 6; c++) tokens[c] = t->offset;
+}
+
+static bool encode_rows(const TimestampTokenizer* t, const char* const* isos, const size_t* lengths,
+                        size_t n, int* tokens, DedupMode mode) {
+    int count;
+    if (mode == DEDUP_AUTO) mode = dedup_strings_worthwhile(isos, lengths, n) ? DEDUP_ON : DEDUP_OFF;
+    if (mode == DEDUP_OFF) {
+        for (size_t i = 0; i < n; i++) timestamp_encode(t, isos[i], tokens + 6 * i, &count);
+        return true;
+    }
+
+    // Parse each distinct string once, into the row of its first occurrence
+    size_t* ids = malloc(2 * n * sizeof(size_t));
+    if (!ids) return false;
+    size_t* first = ids + n;
+    size_t groups = dedup_strings(isos, lengths, n, ids, first);
+    if (groups == 0 && n > 0) {
+        free(ids);
+        return false;
+    }
+    for (size_t g = 0; g < groups; g++) {
+        timestamp_encode(t, isos[first[g]], tokens + 6 * first[g], &count);
+    }
+    for (size_t i = 0; i < n; i++) {
+        size_t row = first[ids[i]];
+        if (row != i) memcpy(tokens + 6 * i, tokens + 6 * row, 6 * sizeof(int));
+    }
+    free(ids);
+    return true;
+}
+
+static int days_in_month(int year, int month) {
+    static const int days[12] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    bool leap = (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+    return month == 2 && leap ? 29 : days[month - 1];
+}
+
+bool timestamp_decode_fields(const TimestampTokenizer* t, const int* tokens, int count, int* fields) {
+    if (count != 6) return false;
+    fields[0] = tokens[0] - t->bucket_offsets[0] + t->min_year;
+    for (int c = 1; c < 6; c++) fields[c] = tokens[c] - t->bucket_offsets[c];
+    return fields_in_range(t, fields) && fields[2] <= days_in_month(fields[0], fields[1]);
+}
+
+bool timestamp_encode_batch(const TimestampTokenizer* t, const char* const* isos, const size_t* lengths,
+                            const uint8_t* validity, size_t n, int* tokens, DedupMode mode) {
+    size_t end;
+    for (size_t start = 0; start < n; start = end) {
+        bool valid;
+        end = validity_run(validity, n, start, &valid);
+        if (valid) {
+            if (!encode_rows(t, isos + start, lengths + start, end - start, tokens + 6 * start, mode)) return false;
+        } else {
+            for (size_t i = start; i < end; i++) timestamp_encode_missing(t, tokens + 6 * i);
+        }
+    }
+    return true;
+}
+
+bool timestamp_is_missing(const TimestampTokenizer* t, const int* tokens, int count) {
+    if (count != 6) return false;
+    for (int c = 0; c < 6; c++) {
+        if (tokens[c] != t->offset) return false;
+    }
+    return true;
+}
+
 void timestamp_decode(const TimestampTokenizer* t, const int* tokens, int count, char* output) {
-    bool valid = true;
+    if (timestamp_is_missing(t, tokens, count)) {
+        strcpy(output, "__missing__");
+        return;
+    }
     // We expect exactly 6 tokens (year, month, day, hour, minute, second)
     if (count != 6) {
         strcpy(output, "__invalid__");
@@ -139,8 +225,8 @@ void timestamp_decode(const TimestampTokenizer* t, const int* tokens, int count,
     tt[3] = tokens[3] - t->bucket_offsets[3];
     tt[4] = tokens[4] - t->bucket_offsets[4];
     tt[5] = tokens[5] - t->bucket_offsets[5];
-    // year = 0 -> invalid date
-    if(tt[0] == 0) {
+    // Unparsable input encodes to each component's first token, which has month 0
+    if (!fields_in_range(t, tt)) {
         strcpy(output, "__invalid__");
         return;
     }
@@ -149,4 +235,48 @@ void timestamp_decode(const TimestampTokenizer* t, const int* tokens, int count,
             tt[0], tt[1], tt[2],
             tt[3], tt[4], tt[5]
     );
-}
\ No newline at end of file
+}
+
+size_t timestamp_logits_width(const TimestampTokenizer* t) {
+    return (size_t)t->bucket_offsets[5] + 60;
+}
+
+void timestamp_decode_logits(const TimestampTokenizer* t, const float* logits, size_t n, size_t stride,
+                             size_t k, int* tokens) {
+    const int* b = t->bucket_offsets;
+    // Valid [first, last) token span of each component; the day span is set per row
+    size_t first[6] = {b[0], b[1] + 1, b[2] + 1, b[3], b[4], b[5]};
+    size_t last[6] = {b[0] + (t->max_year - t->min_year) + 1, b[1] + 13, 0, b[3] + 24, b[4] + 60, b[5] + 60};
+    for (size_t r = 0; r < n; r++) {
+        const float* row = logits + r * stride;
+        int* out = tokens + r * 6 * k;
+        for (int c = 0; c < 6; c++) {
+            if (c == 2) {
+                int year = out[0] - b[0] + t->min_year;
+                int month = out[k] - b[1];
+                // All-NaN month logits leave no best month to bound the days
+                last[2] = first[2] + (month >= 1 && month <= 12 ? days_in_month(year, month) : 31);
+            }
+            if (k == 1) {
+                out[c] = (int)logits_argmax(row, first[c], last[c]);
+            } else {
+                logits_topk(row, first[c], last[c], k, out + c * k);
+            }
+        }
+    }
+}
+
+int64_t timestamp_epoch_seconds(const TimestampTokenizer* t, const int* tokens) {
+    int64_t year = tokens[0] - t->bucket_offsets[0] + t->min_year;
+    int64_t month = tokens[1] - t->bucket_offsets[1];
+    int64_t day = tokens[2] - t->bucket_offsets[2];
+    // Days from civil (proleptic Gregorian), with March as the first month of the year
+    year -= month <= 2;
+    int64_t era = (year >= 0 ? year : year - 399) / 400;
+    int64_t yoe = year - era * 400;
+    int64_t doy = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    int64_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    int64_t days = era * 146097 + doe - 719468;
+    return days * 86400 + (int64_t)(tokens[3] - t->bucket_offsets[3]) * 3600 +
+           (int64_t)(tokens[4] - t->bucket_offsets[4]) * 60 + (tokens[5] - t->bucket_offsets[5]);
+}
@@ -2,7 +2,11 @@
 #define TIMESTAMP_TOKENIZER_H
 
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
 #include <time.h>
+#include "dedup.h"
+#include "validity.h"
 
 typedef struct __attribute__((aligned(8))) {
     int min_year;
@@ -19,7 +23,39 @@ void timestamp_init(TimestampTokenizer* t, int min_year, int max_year, int offse
 // Encode timestamp into tokens
 void timestamp_encode(const TimestampTokenizer* t, const char* iso, int* tokens, int* count);
 
-// Decode tokens into ISO 8601 string
+// Encode year, month, day, hour, minute and second into 6 tokens (each component's
+// first token if any field is out of range, as for an unparsable string)
+void timestamp_encode_fields(const TimestampTokenizer* t, const int* fields, int* tokens);
+
+// The row of a missing timestamp: 6 missing tokens (offset, below every component)
+void timestamp_encode_missing(const TimestampTokenizer* t, int* tokens);
+
+// Encode n timestamps (lengths[i] bytes each) into rows of 6 tokens; rows missing
+// from the validity bitmap (optional) get the missing row and are not read
+// (false on allocation failure)
+bool timestamp_encode_batch(const TimestampTokenizer* t, const char* const* isos, const size_t* lengths,
+                            const uint8_t* validity, size_t n, int* tokens, DedupMode mode);
+
+// Whether tokens are the missing row
+bool timestamp_is_missing(const TimestampTokenizer* t, const int* tokens, int count);
+
+// Decode tokens into ISO 8601 string ("__missing__" / "__invalid__" otherwise)
 void timestamp_decode(const TimestampTokenizer* t, const int* tokens, int count, char* output);
 
+// Year, month, day, hour, minute and second of 6 tokens (false unless count is 6
+// and they form a real date with in-range time fields)
+bool timestamp_decode_fields(const TimestampTokenizer* t, const int* tokens, int count, int* fields);
+
+// Logits a row needs for timestamp_decode_logits (one per token up to the last second)
+size_t timestamp_logits_width(const TimestampTokenizer* t);
+
+// Decode n rows of stride logits into rows of 6 * k tokens: the k best tokens of each
+// component among its valid values (seconds 0-59, days limited to the length of the
+// best year and month), best first
+void timestamp_decode_logits(const TimestampTokenizer* t, const float* logits, size_t n, size_t stride,
+                             size_t k, int* tokens);
+
+// Seconds since 1970-01-01T00:00:00 of a row of 6 valid tokens
+int64_t timestamp_epoch_seconds(const TimestampTokenizer* t, const int* tokens);
+
 #endif
\ No newline at end of file
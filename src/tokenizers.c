@@ -3,10 +3,218 @@
 
 #include <Python.h>
 #include <numpy/arrayobject.h>
+#include <numpy/arrayscalars.h>
+#include <datetime.h>
+#include <math.h>
 
 #include "binary.h"
 #include "category.h"
+#include "codec.h"
+#include "frozen.h"
+#include "histogram.h"
+#include "logits.h"
 #include "timestamp.h"
+#include "scratch.h"
+
+// Grow a scratch-backed int buffer to hold at least n entries (NULL on failure)
+static int* scratch_ints(int* buffer, Py_ssize_t* capacity, Py_ssize_t n) {
+    if (n <= *capacity) return buffer;
+    Py_ssize_t grown = *capacity ? *capacity : 16;
+    while (grown < n) grown *= 2;
+    int* ints = scratch_alloc(grown * sizeof(int));
+    if (!ints) return NULL;
+    *capacity = grown;
+    return ints;
+}
+
+// Map an encode(dedup=...) argument: None is automatic, otherwise its truth value
+static bool parse_dedup(PyObject* obj, DedupMode* mode) {
+    if (obj == Py_None) {
+        *mode = DEDUP_AUTO;
+        return true;
+    }
+    int on = PyObject_IsTrue(obj);
+    if (on < 0) return false;
+    *mode = on ? DEDUP_ON : DEDUP_OFF;
+    return true;
+}
+
+// Map an embed(pooling=...) argument
+static bool parse_pooling(const char* name, EmbedPooling* pooling) {
+    if (strcmp(name, "sum") == 0) {
+        *pooling = EMBED_SUM;
+    } else if (strcmp(name, "mean") == 0) {
+        *pooling = EMBED_MEAN;
+    } else {
+        PyErr_SetString(PyExc_ValueError, "pooling must be 'sum' or 'mean'");
+        return false;
+    }
+    return true;
+}
+
+// A C-contiguous float32 (rows, dim) embedding table with at least min_rows rows
+// (NULL with an exception set otherwise)
+static PyArrayObject* embed_table(PyObject* obj, npy_intp min_rows) {
+    PyArrayObject* table = (PyArrayObject*)PyArray_FROM_OTF(obj, NPY_FLOAT32, NPY_ARRAY_IN_ARRAY);
+    if (!table) return NULL;
+    if (PyArray_NDIM(table) != 2) {
+        Py_DECREF(table);
+        PyErr_SetString(PyExc_ValueError, "Embedding table must be 2-dimensional");
+        return NULL;
+    }
+    if (PyArray_DIM(table, 0) < min_rows) {
+        PyErr_Format(PyExc_ValueError, "Embedding table needs at least %zd rows, got %zd",
+                     (Py_ssize_t)min_rows, (Py_ssize_t)PyArray_DIM(table, 0));
+        Py_DECREF(table);
+        return NULL;
+    }
+    return table;
+}
+
+// A C-contiguous float32 (n, width) logits matrix with width >= min_width
+// (NULL with an exception set otherwise)
+static PyArrayObject* logits_matrix(PyObject* obj, npy_intp min_width) {
+    PyArrayObject* logits = (PyArrayObject*)PyArray_FROM_OTF(obj, NPY_FLOAT32, NPY_ARRAY_IN_ARRAY);
+    if (!logits) return NULL;
+    if (PyArray_NDIM(logits) != 2) {
+        Py_DECREF(logits);
+        PyErr_SetString(PyExc_ValueError, "Logits must be 2-dimensional");
+        return NULL;
+    }
+    if (PyArray_DIM(logits, 1) < min_width) {
+        PyErr_Format(PyExc_ValueError, "Logits need at least %zd columns, got %zd",
+                     (Py_ssize_t)min_width, (Py_ssize_t)PyArray_DIM(logits, 1));
+        Py_DECREF(logits);
+        return NULL;
+    }
+    return logits;
+}
+
+// memory_usage() result: the given parts plus the object itself, this thread's
+// scratch arena and their total, in bytes
+static PyObject* memory_usage_dict(PyObject* self, const char* const* names, const size_t* bytes, size_t count) {
+    PyObject* dict = PyDict_New();
+    if (!dict) return NULL;
+    size_t total = 0;
+    for (size_t i = 0; i <= count + 1; i++) {
+        const char* name = i < count ? names[i] : i == count ? "object" : "scratch";
+        size_t value = i < count ? bytes[i] : i == count ? (size_t)Py_TYPE(self)->tp_basicsize : scratch_capacity();
+        PyObject* item = PyLong_FromSize_t(value);
+        if (!item || PyDict_SetItemString(dict, name, item) < 0) {
+            Py_XDECREF(item);
+            Py_DECREF(dict);
+            return NULL;
+        }
+        Py_DECREF(item);
+        total += value;
+    }
+    PyObject* item = PyLong_FromSize_t(total);
+    if (!item || PyDict_SetItemString(dict, "total", item) < 0) {
+        Py_XDECREF(item);
+        Py_DECREF(dict);
+        return NULL;
+    }
+    Py_DECREF(item);
+    return dict;
+}
+
+// Whether an item stands for a missing value: None, a float NaN, NaT (numpy or
+// pandas) or pd.NA. pandas types are matched by name, so pandas is never imported.
+static bool is_missing(PyObject* obj) {
+    if (obj == Py_None) return true;
+    if (PyFloat_Check(obj)) return isnan(PyFloat_AS_DOUBLE(obj));
+    if (PyArray_IsScalar(obj, Floating)) {
+        double value = PyFloat_AsDouble(obj);
+        if (value == -1.0 && PyErr_Occurred()) {
+            PyErr_Clear();
+            return false;
+        }
+        return isnan(value);
+    }
+    if (PyArray_IsScalar(obj, Datetime)) return ((PyDatetimeScalarObject*)obj)->obval == NPY_DATETIME_NAT;
+    const char* name = Py_TYPE(obj)->tp_name;
+    const char* dot = strrchr(name, '.');
+    if (dot) name = dot + 1;
+    return strcmp(name, "NaTType") == 0 || strcmp(name, "NAType") == 0;
+}
+
+// Copy an encode(validity=...) argument for n rows into a scratch bitmap: a buffer
+// holding an Arrow-style bitmap of at least (n + 7) / 8 bytes, or a boolean mask of
+// n rows. None leaves *bits NULL (every row present). False with an exception set
+// on malformed input.
+static bool parse_validity(PyObject* obj, Py_ssize_t n, uint8_t** bits) {
+    *bits = NULL;
+    if (obj == Py_None) return true;
+    size_t size = validity_bytes((size_t)n);
+    uint8_t* out = scratch_alloc(size ? size : 1);
+    if (!out) {
+        PyErr_NoMemory();
+        return false;
+    }
+    bool mask = PyArray_Check(obj) && PyArray_TYPE((PyArrayObject*)obj) == NPY_BOOL;
+    if (!mask && PyObject_CheckBuffer(obj)) {
+        Py_buffer view;
+        if (PyObject_GetBuffer(obj, &view, PyBUF_SIMPLE) < 0) return false;
+        bool ok = (size_t)view.len >= size;
+        if (ok) memcpy(out, view.buf, size);
+        PyBuffer_Release(&view);
+        if (!ok) {
+            PyErr_Format(PyExc_ValueError, "Validity bitmap needs %zu bytes for %zd rows", size, n);
+            return false;
+        }
+    } else {
+        PyArrayObject* array = (PyArrayObject*)PyArray_FROM_OTF(obj, NPY_BOOL, NPY_ARRAY_IN_ARRAY);
+        if (!array) return false;
+        if (PyArray_SIZE(array) != n) {
+            Py_DECREF(array);
+            PyErr_SetString(PyExc_ValueError, "Expected one validity flag per value");
+            return false;
+        }
+        const npy_bool* flags = PyArray_DATA(array);
+        memset(out, 0, size);
+        for (Py_ssize_t i = 0; i < n; i++) out[i >> 3] |= (uint8_t)(flags[i] != 0) << (i & 7);
+        Py_DECREF(array);
+    }
+    *bits = out;
+    return true;
+}
+
+// Mark row i of n missing, creating an all-present scratch bitmap on first use
+// (false with an exception set on allocation failure)
+static bool mark_missing(uint8_t** bits, Py_ssize_t n, Py_ssize_t i) {
+    if (!*bits) {
+        size_t size = validity_bytes((size_t)n);
+        *bits = scratch_alloc(size);
+        if (!*bits) {
+            PyErr_NoMemory();
+            return false;
+        }
+        memset(*bits, 0xff, size);
+    }
+    validity_clear(*bits, (size_t)i);
+    return true;
+}
+
+// Direct-mapped cache from object address to the index of its first occurrence,
+// scoped to one encode call: the sequence holds a reference to every item, so no
+// address can be freed and reused while the cache lives
+#define IDENTITY_CACHE_BITS 10
+// Probing stops if fewer than 1/8 of this many leading rows hit
+#define IDENTITY_CACHE_TRIAL 4096
+
+typedef struct {
+    PyObject* key;
+    Py_ssize_t index;
+} IdentitySlot;
+
+static inline IdentitySlot* identity_slot(IdentitySlot* cache, PyObject* obj) {
+    uint64_t h = (uint64_t)(uintptr_t)obj * 0x9e3779b97f4a7c15ULL;
+    return &cache[h >> (64 - IDENTITY_CACHE_BITS)];
+}
+
+// Lazily decoded views over category and timestamp tokens (defined below)
+typedef enum { VIEW_CATEGORY, VIEW_TIMESTAMP } ViewKind;
+static PyObject* decoded_view_new(PyObject* tokenizer, PyObject* tokens, ViewKind kind);
 
 // =====================
 // BinaryTokenizer Class
@@ -18,6 +226,7 @@ typedef struct __attribute__((aligned(8))) {
 
 // --- Dealloc, New, Init ---
 static void PyBinaryTokenizer_dealloc(PyBinaryTokenizer* self) {
+    binary_free(&self->tokenizer);
     Py_TYPE(self)->tp_free((PyObject*)self);
 }
 
@@ -36,14 +245,30 @@ static int PyBinaryTokenizer_init(PyBinaryTokenizer* self, PyObject* args, PyObj
     int offset = 0;
     if (!PyArg_ParseTupleAndKeywords(args, kwds, "|ii", kwlist, &num_bits, &offset))
         return -1;
+    binary_free(&self->tokenizer);
     binary_init(&self->tokenizer, num_bits, offset);
     return 0;
 }
 
 // --- Methods: fit, encode, decode ---
-static PyObject* PyBinaryTokenizer_fit(PyBinaryTokenizer* self, PyObject* args) {
+// Group keys as an int64 array matching n values (NULL with an exception set otherwise)
+static PyArrayObject* group_array(PyObject* groups, npy_intp n) {
+    PyArrayObject* array = (PyArrayObject*)PyArray_FROM_OTF(groups, NPY_INT64, NPY_ARRAY_IN_ARRAY);
+    if (!array) return NULL;
+    if (PyArray_SIZE(array) != n) {
+        Py_DECREF(array);
+        PyErr_SetString(PyExc_ValueError, "Expected one group key per value");
+        return NULL;
+    }
+    return array;
+}
+
+static PyObject* PyBinaryTokenizer_fit(PyBinaryTokenizer* self, PyObject* args, PyObject* kwds) {
+    static char* kwlist[] = {"values", "groups", "profile", NULL};
     PyObject* input;
-    if (!PyArg_ParseTuple(args, "O", &input)) return NULL;
+    PyObject* groups = Py_None;
+    int profile = 0;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|Op", kwlist, &input, &groups, &profile)) return NULL;
     PyObject* array = PyArray_FROM_OTF(input, NPY_DOUBLE, NPY_ARRAY_IN_ARRAY);
     if (!array) {
         PyErr_SetString(PyExc_TypeError, "Could not convert input to float array");
@@ -51,14 +276,86 @@ static PyObject* PyBinaryTokenizer_fit(PyBinaryTokenizer* self, PyObject* args)
     }
     double* data = (double*)PyArray_DATA((PyArrayObject*)array);
     npy_intp size = PyArray_SIZE((PyArrayObject*)array);
-    binary_fit(&self->tokenizer, data, size);
+    if (groups == Py_None) {
+        binary_free(&self->tokenizer);
+        if (profile) {
+            Py_BEGIN_ALLOW_THREADS
+            binary_fit_profiled(&self->tokenizer, data, size);
+            Py_END_ALLOW_THREADS
+        } else {
+            binary_fit(&self->tokenizer, data, size);
+        }
+        Py_DECREF(array);
+        Py_RETURN_NONE;
+    }
+
+    PyArrayObject* keys = group_array(groups, size);
+    if (!keys) {
+        Py_DECREF(array);
+        return NULL;
+    }
+    bool ok;
+    Py_BEGIN_ALLOW_THREADS
+    ok = binary_fit_grouped(&self->tokenizer, data, PyArray_DATA(keys), size);
+    // The group pass aggregates per key, so the profile takes its own pass
+    if (ok && profile) {
+        binary_profile(data, size, &self->tokenizer.profile);
+        self->tokenizer.profiled = true;
+    }
+    Py_END_ALLOW_THREADS
+    Py_DECREF(keys);
     Py_DECREF(array);
+    if (!ok) return PyErr_NoMemory();
+    Py_RETURN_NONE;
+}
+
+static PyObject* PyBinaryTokenizer_fit_chunks(PyBinaryTokenizer* self, PyObject* args, PyObject* kwds) {
+    static char* kwlist[] = {"chunks", "profile", NULL};
+    PyObject* chunks;
+    int profile = 0;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|p", kwlist, &chunks, &profile)) return NULL;
+    PyObject* it = PyObject_GetIter(chunks);
+    if (!it) return NULL;
+    BinaryTokenizer fitted = self->tokenizer;
+    fitted.fitted = false;
+    fitted.groups = (BinaryGroupTable){NULL, 0, 0};
+    PyObject* chunk;
+    while ((chunk = PyIter_Next(it))) {
+        PyObject* array = PyArray_FROM_OTF(chunk, NPY_DOUBLE, NPY_ARRAY_IN_ARRAY);
+        Py_DECREF(chunk);
+        if (!array) {
+            Py_DECREF(it);
+            return NULL;
+        }
+        double* data = (double*)PyArray_DATA((PyArrayObject*)array);
+        npy_intp size = PyArray_SIZE((PyArrayObject*)array);
+        if (profile) {
+            binary_fit_update_profiled(&fitted, data, size);
+        } else {
+            binary_fit_update(&fitted, data, size);
+        }
+        Py_DECREF(array);
+    }
+    Py_DECREF(it);
+    if (PyErr_Occurred()) return NULL;
+    // Only commit the range once the whole stream was consumed
+    binary_free(&self->tokenizer);
+    self->tokenizer = fitted;
     Py_RETURN_NONE;
 }
 
-static PyObject* PyBinaryTokenizer_encode(PyBinaryTokenizer* self, PyObject* args) {
+static PyObject* PyBinaryTokenizer_encode(PyBinaryTokenizer* self, PyObject* args, PyObject* kwds) {
+    static char* kwlist[] = {"values", "dedup", "groups", "fallback", "validity", NULL};
     PyObject* input;
-    if (!PyArg_ParseTuple(args, "O", &input)) return NULL;
+    PyObject* dedup = Py_None;
+    PyObject* groups = Py_None;
+    PyObject* validity = Py_None;
+    int fallback = 1;
+    DedupMode mode;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|OOpO", kwlist, &input, &dedup, &groups, &fallback,
+                                     &validity))
+        return NULL;
+    if (!parse_dedup(dedup, &mode)) return NULL;
 
     // Initialize NumPy API (only once)
     import_array();
@@ -67,12 +364,18 @@ static PyObject* PyBinaryTokenizer_encode(PyBinaryTokenizer* self, PyObject* arg
         numpy_initialized = 1;
     }
 
-    if (PyFloat_Check(input)) {
-        // Single float case - return 1D array of indices
-        double value = PyFloat_AsDouble(input);
+    if (PyFloat_Check(input) || input == Py_None) {
+        // Single float case - return 1D array of indices (None is missing, like NaN)
+        double value = input == Py_None ? NAN : PyFloat_AsDouble(input);
         int indices[self->tokenizer.num_bits + 2];
         int count;
-        binary_encode(&self->tokenizer, value, indices, &count);
+        if (groups != Py_None) {
+            int64_t group = PyLong_AsLongLong(groups);
+            if (group == -1 && PyErr_Occurred()) return NULL;
+            binary_encode_grouped_batch(&self->tokenizer, &value, &group, NULL, 1, indices, &count, fallback);
+        } else {
+            binary_encode(&self->tokenizer, value, indices, &count);
+        }
 
         npy_intp dims[1] = {count};
         PyObject* np_array = PyArray_SimpleNew(1, dims, NPY_INT32);
@@ -83,43 +386,63 @@ static PyObject* PyBinaryTokenizer_encode(PyBinaryTokenizer* self, PyObject* arg
         return np_array;
 
     } else if (PySequence_Check(input)) {
-        // Sequence case - return array of arrays
+        // Sequence case - convert, encode as a batch, then return array of arrays
         PyObject* seq = PySequence_Fast(input, "Expected a sequence");
         if (!seq) return NULL;
 
         Py_ssize_t len = PySequence_Fast_GET_SIZE(seq);
-        PyObject* output = PyList_New(len);
-        if (!output) {
-            Py_DECREF(seq);
-            return NULL;
+        PyObject** items = PySequence_Fast_ITEMS(seq);
+        size_t stride = self->tokenizer.num_bits;
+        PyObject* output = NULL;
+        PyArrayObject* keys = NULL;
+        uint8_t* bits;
+        ScratchMark mark = scratch_mark();
+        double* values = scratch_alloc(len * sizeof(double));
+        int* counts = scratch_alloc(len * sizeof(int));
+        int* tokens = scratch_alloc(len * stride * sizeof(int));
+        if (!values || !counts || !tokens) {
+            PyErr_NoMemory();
+            goto done;
         }
-
+        if (!parse_validity(validity, len, &bits)) goto done;
         for (Py_ssize_t i = 0; i < len; i++) {
-            PyObject* item = PySequence_Fast_GET_ITEM(seq, i);
-            double value = PyFloat_AsDouble(item);
-            if (PyErr_Occurred()) {
-                Py_DECREF(seq);
-                Py_DECREF(output);
-                return NULL;
+            if (PyFloat_Check(items[i])) {
+                values[i] = PyFloat_AS_DOUBLE(items[i]);
+            } else if (is_missing(items[i]) || !validity_get(bits, i)) {
+                values[i] = NAN;    // encodes to the missing token
+            } else {
+                values[i] = PyFloat_AsDouble(items[i]);
+                if (values[i] == -1.0 && PyErr_Occurred()) goto done;
             }
+        }
+        if (groups != Py_None) {
+            // Group ranges are looked up per row, so there is nothing to deduplicate
+            keys = group_array(groups, len);
+            if (!keys) goto done;
+            binary_encode_grouped_batch(&self->tokenizer, values, PyArray_DATA(keys), bits, len,
+                                        tokens, counts, fallback);
+        } else if (!binary_encode_batch(&self->tokenizer, values, bits, len, tokens, counts, mode)) {
+            PyErr_NoMemory();
+            goto done;
+        }
 
-            int indices[self->tokenizer.num_bits + 2];
-            int count;
-            binary_encode(&self->tokenizer, value, indices, &count);
-
-            npy_intp dims[1] = {count};
+        output = PyList_New(len);
+        if (!output) goto done;
+        for (Py_ssize_t i = 0; i < len; i++) {
+            npy_intp dims[1] = {counts[i]};
             PyObject* np_array = PyArray_SimpleNew(1, dims, NPY_INT32);
             if (!np_array) {
-                Py_DECREF(seq);
-                Py_DECREF(output);
-                return NULL;
+                Py_CLEAR(output);
+                goto done;
             }
-
             int* data = (int*)PyArray_DATA((PyArrayObject*)np_array);
-            memcpy(data, indices, count * sizeof(int));
+            memcpy(data, tokens + i * stride, counts[i] * sizeof(int));
             PyList_SET_ITEM(output, i, np_array);
         }
 
+    done:
+        scratch_release_to(mark);
+        Py_XDECREF(keys);
         Py_DECREF(seq);
         return output;
     } else {
@@ -171,41 +494,252 @@ static PyObject* __PyBinaryTokenizer_encode(PyBinaryTokenizer* self, PyObject* a
     }
 }
 
-static PyObject* PyBinaryTokenizer_decode(PyBinaryTokenizer* self, PyObject* args) {
+static PyObject* PyBinaryTokenizer_decode(PyBinaryTokenizer* self, PyObject* args, PyObject* kwds) {
+    static char* kwlist[] = {"tokens", "groups", "fallback", NULL};
     PyObject* input;
-    if (!PyArg_ParseTuple(args, "O", &input)) return NULL;
+    PyObject* groups = Py_None;
+    int fallback = 1;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|Op", kwlist, &input, &groups, &fallback)) return NULL;
 
     if (PySequence_Check(input)) {
         Py_ssize_t len_input = PySequence_Size(input);
         if (len_input <= 0) return NULL;
+        PyArrayObject* keys = NULL;
+        if (groups != Py_None) {
+            keys = group_array(groups, len_input);
+            if (!keys) return NULL;
+        }
         PyObject* output = PyList_New(len_input);
-        if (!output) return NULL;
+        if (!output) {
+            Py_XDECREF(keys);
+            return NULL;
+        }
+        ScratchMark mark = scratch_mark();
+        int* indices = NULL;
+        Py_ssize_t capacity = 0;
         for (Py_ssize_t i = 0; i < len_input; i++) {
             double value;
             PyObject* tokens = PySequence_GetItem(input, i);
-            if (!tokens) return NULL;
+            if (!tokens) goto error;
             Py_ssize_t len = PySequence_Size(tokens);
-            if (len < 0) return NULL;
+            if (len < 0) {
+                Py_DECREF(tokens);
+                goto error;
+            }
             if (len == 0) value = NAN;
             if (len > 0) {
-                int indices[len];
+                indices = scratch_ints(indices, &capacity, len);
+                if (!indices) {
+                    Py_DECREF(tokens);
+                    PyErr_NoMemory();
+                    goto error;
+                }
                 for (Py_ssize_t j = 0; j < len; j++) {
                     PyObject* item = PySequence_GetItem(tokens, j);
+                    if (!item) {
+                        Py_DECREF(tokens);
+                        goto error;
+                    }
                     indices[j] = PyLong_AsLong(item);
                     Py_DECREF(item);
-                    if (PyErr_Occurred()) return NULL;
+                    if (PyErr_Occurred()) {
+                        Py_DECREF(tokens);
+                        goto error;
+                    }
                 }
-                value = binary_decode(&self->tokenizer, indices, len);
+                value = keys ? binary_decode_grouped(&self->tokenizer, indices, len,
+                                                     ((int64_t*)PyArray_DATA(keys))[i], fallback)
+                             : binary_decode(&self->tokenizer, indices, len);
             }
+            Py_DECREF(tokens);
             PyList_SET_ITEM(output, i, PyFloat_FromDouble(value));
         }
+        scratch_release_to(mark);
+        Py_XDECREF(keys);
         return output;
+    error:
+        scratch_release_to(mark);
+        Py_XDECREF(keys);
+        Py_DECREF(output);
+        return NULL;
     } else {
         PyErr_SetString(PyExc_TypeError, "Expected a sequence of sequences.");
         return NULL;
     }
 }
 
+// --- Methods: decode_probs, encode_bins, decode_bins ---
+static PyObject* PyBinaryTokenizer_decode_probs(PyBinaryTokenizer* self, PyObject* args, PyObject* kwds) {
+    static char* kwlist[] = {"probs", "groups", "fallback", "variance", "map", NULL};
+    PyObject* input;
+    PyObject* groups = Py_None;
+    int fallback = 1, want_var = 0, want_map = 0;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|Oppp", kwlist, &input, &groups, &fallback,
+                                     &want_var, &want_map))
+        return NULL;
+
+    const BinaryTokenizer* t = &self->tokenizer;
+    PyArrayObject* probs = (PyArrayObject*)PyArray_FROM_OTF(input, NPY_FLOAT32,
+                                                            NPY_ARRAY_IN_ARRAY | NPY_ARRAY_FORCECAST);
+    if (!probs) return NULL;
+    if (PyArray_NDIM(probs) != 2 || PyArray_DIM(probs, 1) != t->num_bits) {
+        PyErr_Format(PyExc_ValueError, "Expected probabilities of shape (n, %d)", t->num_bits);
+        Py_DECREF(probs);
+        return NULL;
+    }
+    npy_intp n = PyArray_DIM(probs, 0);
+    PyArrayObject* keys = NULL;
+    if (groups != Py_None && !(keys = group_array(groups, n))) {
+        Py_DECREF(probs);
+        return NULL;
+    }
+
+    PyArrayObject* outputs[3] = {NULL, NULL, NULL};
+    int wanted[3] = {1, want_var, want_map};
+    bool ok = true;
+    for (int k = 0; k < 3 && ok; k++) {
+        if (wanted[k]) ok = (outputs[k] = (PyArrayObject*)PyArray_SimpleNew(1, &n, NPY_DOUBLE)) != NULL;
+    }
+    if (ok) {
+        Py_BEGIN_ALLOW_THREADS
+        binary_decode_probs(t, PyArray_DATA(probs), (size_t)n, keys ? PyArray_DATA(keys) : NULL, fallback,
+                            PyArray_DATA(outputs[0]),
+                            outputs[1] ? PyArray_DATA(outputs[1]) : NULL,
+                            outputs[2] ? PyArray_DATA(outputs[2]) : NULL);
+        Py_END_ALLOW_THREADS
+    }
+    Py_DECREF(probs);
+    Py_XDECREF(keys);
+    if (!ok) {
+        for (int k = 0; k < 3; k++) Py_XDECREF(outputs[k]);
+        return NULL;
+    }
+    if (!want_var && !want_map) return (PyObject*)outputs[0];
+
+    PyObject* result = PyTuple_New(1 + want_var + want_map);
+    if (!result) {
+        for (int k = 0; k < 3; k++) Py_XDECREF(outputs[k]);
+        return NULL;
+    }
+    Py_ssize_t pos = 0;
+    for (int k = 0; k < 3; k++) {
+        if (outputs[k]) PyTuple_SET_ITEM(result, pos++, (PyObject*)outputs[k]);
+    }
+    return result;
+}
+
+// Bin tokens need 2 + 2^num_bits ids past the offset
+static bool check_bin_bits(const BinaryTokenizer* t) {
+    if (t->num_bits <= BINARY_MAX_BIN_BITS && t->offset + 2 + ((int64_t)1 << t->num_bits) <= INT32_MAX) return true;
+    PyErr_Format(PyExc_ValueError, "Bin tokens need num_bits <= %d and offset + 2 + 2^num_bits to fit an int32",
+                 BINARY_MAX_BIN_BITS);
+    return false;
+}
+
+static PyObject* PyBinaryTokenizer_encode_bins(PyBinaryTokenizer* self, PyObject* args, PyObject* kwds) {
+    static char* kwlist[] = {"values", "groups", "fallback", "validity", NULL};
+    PyObject* input;
+    PyObject* groups = Py_None;
+    PyObject* validity = Py_None;
+    int fallback = 1;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|OpO", kwlist, &input, &groups, &fallback, &validity))
+        return NULL;
+    if (!check_bin_bits(&self->tokenizer)) return NULL;
+
+    PyArrayObject* values = (PyArrayObject*)PyArray_FROM_OTF(input, NPY_DOUBLE, NPY_ARRAY_IN_ARRAY);
+    if (!values) return NULL;
+    ScratchMark mark = scratch_mark();
+    PyArrayObject* keys = NULL;
+    PyArrayObject* out = NULL;
+    uint8_t* bits;
+    if (groups != Py_None && !(keys = group_array(groups, PyArray_SIZE(values)))) goto done;
+    if (!parse_validity(validity, PyArray_SIZE(values), &bits)) goto done;
+    out = (PyArrayObject*)PyArray_SimpleNew(PyArray_NDIM(values), PyArray_DIMS(values), NPY_INT32);
+    if (out) {
+        Py_BEGIN_ALLOW_THREADS
+        binary_encode_bins(&self->tokenizer, PyArray_DATA(values), keys ? PyArray_DATA(keys) : NULL, bits,
+                           (size_t)PyArray_SIZE(values), fallback, PyArray_DATA(out));
+        Py_END_ALLOW_THREADS
+    }
+done:
+    scratch_release_to(mark);
+    Py_DECREF(values);
+    Py_XDECREF(keys);
+    return (PyObject*)out;
+}
+
+static PyObject* PyBinaryTokenizer_decode_bins(PyBinaryTokenizer* self, PyObject* args, PyObject* kwds) {
+    static char* kwlist[] = {"tokens", "groups", "fallback", NULL};
+    PyObject* input;
+    PyObject* groups = Py_None;
+    int fallback = 1;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|Op", kwlist, &input, &groups, &fallback)) return NULL;
+    if (!check_bin_bits(&self->tokenizer)) return NULL;
+
+    PyArrayObject* tokens = (PyArrayObject*)PyArray_FROM_OTF(input, NPY_INT32, NPY_ARRAY_IN_ARRAY);
+    if (!tokens) return NULL;
+    PyArrayObject* keys = NULL;
+    if (groups != Py_None && !(keys = group_array(groups, PyArray_SIZE(tokens)))) {
+        Py_DECREF(tokens);
+        return NULL;
+    }
+    PyArrayObject* out = (PyArrayObject*)PyArray_SimpleNew(PyArray_NDIM(tokens), PyArray_DIMS(tokens), NPY_DOUBLE);
+    if (out) {
+        Py_BEGIN_ALLOW_THREADS
+        binary_decode_bins(&self->tokenizer, PyArray_DATA(tokens), keys ? PyArray_DATA(keys) : NULL,
+                           (size_t)PyArray_SIZE(tokens), fallback, PyArray_DATA(out));
+        Py_END_ALLOW_THREADS
+    }
+    Py_DECREF(tokens);
+    Py_XDECREF(keys);
+    return (PyObject*)out;
+}
+
+// --- Methods: embed ---
+static PyObject* PyBinaryTokenizer_embed(PyBinaryTokenizer* self, PyObject* args, PyObject* kwds) {
+    static char* kwlist[] = {"values", "table", "pooling", NULL};
+    PyObject* input;
+    PyObject* table_obj;
+    const char* pooling_name = "sum";
+    EmbedPooling pooling;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "OO|s", kwlist, &input, &table_obj, &pooling_name))
+        return NULL;
+    if (!parse_pooling(pooling_name, &pooling)) return NULL;
+
+    const BinaryTokenizer* t = &self->tokenizer;
+    PyArrayObject* table = embed_table(table_obj, (npy_intp)t->offset + t->num_bits + 1);
+    if (!table) return NULL;
+    PyArrayObject* values = (PyArrayObject*)PyArray_FROM_OTF(input, NPY_DOUBLE, NPY_ARRAY_IN_ARRAY);
+    if (!values) {
+        Py_DECREF(table);
+        return NULL;
+    }
+    npy_intp dims[2] = {PyArray_SIZE(values), PyArray_DIM(table, 1)};
+    PyArrayObject* out = (PyArrayObject*)PyArray_SimpleNew(2, dims, NPY_FLOAT32);
+    if (out) {
+        Py_BEGIN_ALLOW_THREADS
+        binary_embed_batch(t, PyArray_DATA(values), (size_t)dims[0], PyArray_DATA(table), (size_t)dims[1],
+                           PyArray_DATA(out), pooling);
+        Py_END_ALLOW_THREADS
+    }
+    Py_DECREF(values);
+    Py_DECREF(table);
+    return (PyObject*)out;
+}
+
+// --- Methods: memory_usage, shrink_to_fit ---
+static PyObject* PyBinaryTokenizer_memory_usage(PyBinaryTokenizer* self, PyObject* Py_UNUSED(ignored)) {
+    static const char* const names[] = {"groups"};
+    size_t bytes[] = {binary_memory_usage(&self->tokenizer)};
+    return memory_usage_dict((PyObject*)self, names, bytes, 1);
+}
+
+static PyObject* PyBinaryTokenizer_shrink_to_fit(PyBinaryTokenizer* self, PyObject* Py_UNUSED(ignored)) {
+    if (!binary_shrink_to_fit(&self->tokenizer)) return PyErr_NoMemory();
+    scratch_release();
+    Py_RETURN_NONE;
+}
+
 // --- Getters ---
 static PyObject* PyBinaryTokenizer_get_num_bits(PyBinaryTokenizer* self, void* closure) {
     return PyLong_FromLong(self->tokenizer.fitted ? self->tokenizer.num_bits : -1);
@@ -215,17 +749,182 @@ static PyObject* PyBinaryTokenizer_get_max_active_features(PyBinaryTokenizer* se
     return PyLong_FromLong(self->tokenizer.fitted ? self->tokenizer.num_bits : -1);
 }
 
+static PyObject* PyBinaryTokenizer_get_num_groups(PyBinaryTokenizer* self, void* closure) {
+    return PyLong_FromSize_t(self->tokenizer.groups.count);
+}
+
+static PyObject* profile_to_dict(const BinaryProfile* p) {
+    npy_intp dims[1] = {BINARY_PROFILE_BUCKETS};
+    PyObject* histogram = PyArray_SimpleNew(1, dims, NPY_UINT64);
+    if (!histogram) return NULL;
+    memcpy(PyArray_DATA((PyArrayObject*)histogram), p->histogram, sizeof(p->histogram));
+    return Py_BuildValue("{s:K,s:K,s:K,s:d,s:d,s:d,s:d,s:N}",
+        "count", (unsigned long long)p->count,
+        "nan_count", (unsigned long long)p->nan_count,
+        "zero_count", (unsigned long long)p->zero_count,
+        "mean", p->mean,
+        "variance", p->count ? p->m2 / (double)p->count : NAN,
+        "min", p->min_val,
+        "max", p->max_val,
+        "histogram", histogram);
+}
+
+// Inverse of profile_to_dict (false with an exception set on malformed input)
+static bool profile_from_dict(PyObject* dict, BinaryProfile* p) {
+    PyObject* values[8];
+    const char* keys[8] = {"count", "nan_count", "zero_count", "mean", "variance", "min", "max", "histogram"};
+    for (int i = 0; i < 8; i++) {
+        values[i] = PyDict_Check(dict) ? PyDict_GetItemString(dict, keys[i]) : NULL;
+        if (!values[i]) {
+            PyErr_Format(PyExc_ValueError, "Profile state is missing '%s'", keys[i]);
+            return false;
+        }
+    }
+    p->count = PyLong_AsUnsignedLongLong(values[0]);
+    p->nan_count = PyLong_AsUnsignedLongLong(values[1]);
+    p->zero_count = PyLong_AsUnsignedLongLong(values[2]);
+    p->mean = PyFloat_AsDouble(values[3]);
+    double variance = PyFloat_AsDouble(values[4]);
+    p->m2 = p->count ? variance * (double)p->count : 0.0;
+    p->min_val = PyFloat_AsDouble(values[5]);
+    p->max_val = PyFloat_AsDouble(values[6]);
+    if (PyErr_Occurred()) return false;
+    PyArrayObject* histogram = (PyArrayObject*)PyArray_FROM_OTF(values[7], NPY_UINT64, NPY_ARRAY_IN_ARRAY);
+    if (!histogram) return false;
+    bool ok = PyArray_SIZE(histogram) == BINARY_PROFILE_BUCKETS;
+    if (ok) memcpy(p->histogram, PyArray_DATA(histogram), sizeof(p->histogram));
+    else PyErr_SetString(PyExc_ValueError, "Profile histogram has the wrong size");
+    Py_DECREF(histogram);
+    return ok;
+}
+
+static PyObject* PyBinaryTokenizer_get_profile(PyBinaryTokenizer* self, void* closure) {
+    if (!self->tokenizer.profiled) Py_RETURN_NONE;
+    return profile_to_dict(&self->tokenizer.profile);
+}
+
+// --- Methods: get_state, set_state (pickling support) ---
+static PyObject* PyBinaryTokenizer_get_state(PyBinaryTokenizer* self, PyObject* Py_UNUSED(ignored)) {
+    const BinaryTokenizer* t = &self->tokenizer;
+    PyObject* groups = Py_None;
+    Py_INCREF(groups);
+    if (t->groups.count) {
+        npy_intp dims[1] = {(npy_intp)t->groups.count};
+        PyObject* keys = PyArray_SimpleNew(1, dims, NPY_INT64);
+        PyObject* mins = PyArray_SimpleNew(1, dims, NPY_DOUBLE);
+        PyObject* maxs = PyArray_SimpleNew(1, dims, NPY_DOUBLE);
+        if (!keys || !mins || !maxs) {
+            Py_XDECREF(keys);
+            Py_XDECREF(mins);
+            Py_XDECREF(maxs);
+            Py_DECREF(groups);
+            return NULL;
+        }
+        size_t k = 0;
+        for (size_t s = 0; s <= t->groups.mask; s++) {
+            const BinaryGroup* g = &t->groups.slots[s];
+            if (!g->used) continue;
+            ((int64_t*)PyArray_DATA((PyArrayObject*)keys))[k] = g->key;
+            ((double*)PyArray_DATA((PyArrayObject*)mins))[k] = g->min_val;
+            ((double*)PyArray_DATA((PyArrayObject*)maxs))[k] = g->max_val;
+            k++;
+        }
+        Py_DECREF(groups);
+        groups = Py_BuildValue("(NNN)", keys, mins, maxs);
+        if (!groups) return NULL;
+    }
+    PyObject* profile = Py_None;
+    Py_INCREF(profile);
+    if (t->profiled) {
+        Py_DECREF(profile);
+        profile = profile_to_dict(&t->profile);
+    }
+    if (!profile) {
+        Py_DECREF(groups);
+        return NULL;
+    }
+    return Py_BuildValue("{s:i,s:i,s:O,s:d,s:d,s:N,s:N}",
+        "num_bits", t->num_bits,
+        "offset", t->offset,
+        "fitted", t->fitted ? Py_True : Py_False,
+        "min_val", t->min_val,
+        "max_val", t->max_val,
+        "groups", groups,
+        "profile", profile);
+}
+
+static PyObject* PyBinaryTokenizer_set_state(PyBinaryTokenizer* self, PyObject* args) {
+    PyObject* state;
+    if (!PyArg_ParseTuple(args, "O!", &PyDict_Type, &state)) return NULL;
+    PyObject* fitted = PyDict_GetItemString(state, "fitted");
+    PyObject* min_val = PyDict_GetItemString(state, "min_val");
+    PyObject* max_val = PyDict_GetItemString(state, "max_val");
+    PyObject* groups = PyDict_GetItemString(state, "groups");
+    PyObject* profile = PyDict_GetItemString(state, "profile");
+    if (!fitted || !min_val || !max_val) {
+        PyErr_SetString(PyExc_ValueError, "Incomplete tokenizer state");
+        return NULL;
+    }
+
+    BinaryTokenizer t = self->tokenizer;
+    t.groups = (BinaryGroupTable){NULL, 0, 0};
+    t.fitted = PyObject_IsTrue(fitted) == 1;
+    t.min_val = PyFloat_AsDouble(min_val);
+    t.max_val = PyFloat_AsDouble(max_val);
+    t.profiled = profile && profile != Py_None;
+    if (PyErr_Occurred() || (t.profiled && !profile_from_dict(profile, &t.profile))) return NULL;
+    if (groups && groups != Py_None) {
+        PyObject *keys_obj, *mins_obj, *maxs_obj;
+        if (!PyArg_ParseTuple(groups, "OOO", &keys_obj, &mins_obj, &maxs_obj)) return NULL;
+        PyArrayObject* keys = (PyArrayObject*)PyArray_FROM_OTF(keys_obj, NPY_INT64, NPY_ARRAY_IN_ARRAY);
+        PyArrayObject* mins = (PyArrayObject*)PyArray_FROM_OTF(mins_obj, NPY_DOUBLE, NPY_ARRAY_IN_ARRAY);
+        PyArrayObject* maxs = (PyArrayObject*)PyArray_FROM_OTF(maxs_obj, NPY_DOUBLE, NPY_ARRAY_IN_ARRAY);
+        bool ok = keys && mins && maxs &&
+                  PyArray_SIZE(mins) == PyArray_SIZE(keys) && PyArray_SIZE(maxs) == PyArray_SIZE(keys);
+        if (keys && mins && maxs && !ok) PyErr_SetString(PyExc_ValueError, "Group state arrays differ in length");
+        for (npy_intp i = 0; ok && i < PyArray_SIZE(keys); i++) {
+            ok = binary_add_group(&t, ((int64_t*)PyArray_DATA(keys))[i],
+                                  ((double*)PyArray_DATA(mins))[i], ((double*)PyArray_DATA(maxs))[i]);
+            if (!ok) PyErr_NoMemory();
+        }
+        Py_XDECREF(keys);
+        Py_XDECREF(mins);
+        Py_XDECREF(maxs);
+        if (!ok) {
+            binary_free(&t);
+            return NULL;
+        }
+    }
+    binary_free(&self->tokenizer);
+    self->tokenizer = t;
+    Py_RETURN_NONE;
+}
+
 // --- Method Table & Type ---
 static PyMethodDef PyBinaryTokenizer_methods[] = {
-    {"fit", (PyCFunction)PyBinaryTokenizer_fit, METH_VARARGS, "Fit to data"},
-    {"encode", (PyCFunction)PyBinaryTokenizer_encode, METH_VARARGS, "Encode values"},
-    {"decode", (PyCFunction)PyBinaryTokenizer_decode, METH_VARARGS, "Decode tokens"},
+    {"fit", (PyCFunction)PyBinaryTokenizer_fit, METH_VARARGS | METH_KEYWORDS, "Fit to data"},
+    {"fit_chunks", (PyCFunction)PyBinaryTokenizer_fit_chunks, METH_VARARGS | METH_KEYWORDS, "Fit to an iterable of chunks"},
+    {"encode", (PyCFunction)PyBinaryTokenizer_encode, METH_VARARGS | METH_KEYWORDS, "Encode values"},
+    {"decode", (PyCFunction)PyBinaryTokenizer_decode, METH_VARARGS | METH_KEYWORDS, "Decode tokens"},
+    {"get_state", (PyCFunction)PyBinaryTokenizer_get_state, METH_NOARGS, "Snapshot of the fitted state"},
+    {"set_state", (PyCFunction)PyBinaryTokenizer_set_state, METH_VARARGS, "Restore a snapshot"},
+    {"encode_bins", (PyCFunction)PyBinaryTokenizer_encode_bins, METH_VARARGS | METH_KEYWORDS,
+     "Encode values into one bin token each"},
+    {"decode_bins", (PyCFunction)PyBinaryTokenizer_decode_bins, METH_VARARGS | METH_KEYWORDS,
+     "Decode bin tokens"},
+    {"decode_probs", (PyCFunction)PyBinaryTokenizer_decode_probs, METH_VARARGS | METH_KEYWORDS,
+     "Decode per-bit probabilities"},
+    {"embed", (PyCFunction)PyBinaryTokenizer_embed, METH_VARARGS | METH_KEYWORDS, "Encode and pool embedding rows"},
+    {"memory_usage", (PyCFunction)PyBinaryTokenizer_memory_usage, METH_NOARGS, "Bytes held, by structure"},
+    {"shrink_to_fit", (PyCFunction)PyBinaryTokenizer_shrink_to_fit, METH_NOARGS, "Release unused capacity"},
     {NULL}
 };
 
 static PyGetSetDef PyBinaryTokenizer_getset[] = {
     {"num_bits", (getter)PyBinaryTokenizer_get_num_bits, NULL, "Number of bits (+2 sentinels)", NULL},
     {"max_active_features", (getter)PyBinaryTokenizer_get_max_active_features, NULL, "Maximum active features", NULL},
+    {"num_groups", (getter)PyBinaryTokenizer_get_num_groups, NULL, "Number of fitted group ranges", NULL},
+    {"profile", (getter)PyBinaryTokenizer_get_profile, NULL, "Distribution profile from the last fit", NULL},
     {NULL}
 };
 
@@ -269,30 +968,53 @@ static PyObject* PyCategoryTokenizer_new(PyTypeObject* type, PyObject* args, PyO
 
 static int PyCategoryTokenizer_init(PyCategoryTokenizer* self, PyObject* args, PyObject* kwds) {
     int offset = 0;
+    double bloom_fpr = 0.0;
     PyObject* categories = NULL;
-    static char* kwlist[] = {"categories", "offset", NULL};
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|Oi", kwlist, &categories, &offset))
+    const char* order = "sorted";
+    static char* kwlist[] = {"categories", "offset", "bloom_fpr", "order", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|Oids", kwlist, &categories, &offset, &bloom_fpr, &order))
         return -1;
     
     if(offset) {
         if(offset > 0) category_init(&self->tokenizer, offset);
     }
+    if (bloom_fpr < 0.0 || bloom_fpr >= 1.0) {
+        PyErr_SetString(PyExc_ValueError, "bloom_fpr must be in [0, 1)");
+        return -1;
+    }
+    category_set_bloom(&self->tokenizer, bloom_fpr);
+    if (strcmp(order, "sorted") == 0) {
+        category_set_order(&self->tokenizer, CATEGORY_ORDER_SORTED);
+    } else if (strcmp(order, "frequency") == 0) {
+        category_set_order(&self->tokenizer, CATEGORY_ORDER_FREQUENCY);
+    } else {
+        PyErr_SetString(PyExc_ValueError, "order must be 'sorted' or 'frequency'");
+        return -1;
+    }
 
     if (categories) 
     {
         PyObject* seq = PySequence_Fast(categories, "Expected a sequence");
         if (!seq) return -1;
         Py_ssize_t len = PySequence_Fast_GET_SIZE(seq);
-        const char* values[len];
+        ScratchMark mark = scratch_mark();
+        const char** values = scratch_alloc(len * sizeof(char*));
+        if (!values) {
+            Py_DECREF(seq);
+            PyErr_NoMemory();
+            return -1;
+        }
         for (Py_ssize_t i = 0; i < len; i++) {
             PyObject* item = PySequence_Fast_GET_ITEM(seq, i);
             values[i] = PyUnicode_AsUTF8(item);
             if (!values[i]) {
+                scratch_release_to(mark);
                 Py_DECREF(seq);
                 return -1;
             }
         }
         category_fit(&self->tokenizer, values, len);
+        scratch_release_to(mark);
         Py_DECREF(seq);
     }
     return 0;
@@ -305,23 +1027,194 @@ static PyObject* PyCategoryTokenizer_fit(PyCategoryTokenizer* self, PyObject* ar
     PyObject* seq = PySequence_Fast(values, "Expected a sequence");
     if (!seq) return NULL;
     Py_ssize_t len = PySequence_Fast_GET_SIZE(seq);
-    const char* c_values[len];
+    ScratchMark mark = scratch_mark();
+    const char** c_values = scratch_alloc(len * sizeof(char*));
+    if (!c_values) {
+        Py_DECREF(seq);
+        return PyErr_NoMemory();
+    }
     for (Py_ssize_t i = 0; i < len; i++) {
         PyObject* item = PySequence_Fast_GET_ITEM(seq, i);
         c_values[i] = PyUnicode_AsUTF8(item);
         if (!c_values[i]) {
+            scratch_release_to(mark);
             Py_DECREF(seq);
             return NULL;
         }
     }
     category_fit(&self->tokenizer, c_values, len);
+    scratch_release_to(mark);
+    Py_DECREF(seq);
+    Py_RETURN_NONE;
+}
+
+static PyObject* PyCategoryTokenizer_fit_chunks(PyCategoryTokenizer* self, PyObject* args, PyObject* kwds) {
+    static char* kwlist[] = {"chunks", "sample_size", "seed", NULL};
+    PyObject* chunks;
+    Py_ssize_t sample_size = 0;
+    unsigned long long seed = 0;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|nK", kwlist, &chunks, &sample_size, &seed))
+        return NULL;
+    if (sample_size < 0) {
+        PyErr_SetString(PyExc_ValueError, "sample_size must be non-negative");
+        return NULL;
+    }
+    PyObject* it = PyObject_GetIter(chunks);
+    if (!it) return NULL;
+
+    // Exact: running counter of unique keys. Sampled: uniform reservoir of rows.
+    CategoryCounter counter;
+    category_counter_init(&counter);
+    CategoryReservoir reservoir;
+    if (sample_size > 0 && !category_reservoir_init(&reservoir, sample_size, seed)) {
+        Py_DECREF(it);
+        return PyErr_NoMemory();
+    }
+
+    PyObject* chunk;
+    bool ok = true;
+    while (ok && (chunk = PyIter_Next(it))) {
+        PyObject* seq = PySequence_Fast(chunk, "Expected each chunk to be a sequence");
+        Py_DECREF(chunk);
+        if (!seq) {
+            ok = false;
+            break;
+        }
+        Py_ssize_t len = PySequence_Fast_GET_SIZE(seq);
+        for (Py_ssize_t i = 0; i < len && ok; i++) {
+            const char* value = PyUnicode_AsUTF8(PySequence_Fast_GET_ITEM(seq, i));
+            if (!value) {
+                ok = false;
+            } else if (sample_size > 0 ? !category_reservoir_add(&reservoir, value)
+                                       : !category_counter_add(&counter, value, 1)) {
+                PyErr_NoMemory();
+                ok = false;
+            }
+        }
+        Py_DECREF(seq);
+    }
+    Py_DECREF(it);
+    if (ok && PyErr_Occurred()) ok = false;
+
+    if (ok && sample_size > 0) {
+        for (size_t i = 0; i < reservoir.size && ok; i++) {
+            if (!category_counter_add(&counter, reservoir.items[i], 1)) {
+                PyErr_NoMemory();
+                ok = false;
+            }
+        }
+    }
+    if (sample_size > 0) category_reservoir_free(&reservoir);
+    if (ok && !category_counter_sort(&counter)) {
+        PyErr_NoMemory();
+        ok = false;
+    }
+    if (ok) category_fit_counter(&self->tokenizer, &counter);
+    category_counter_free(&counter);
+    if (!ok) return NULL;
+    Py_RETURN_NONE;
+}
+
+// --- Methods: partial fit states ---
+static PyObject* counter_to_bytes(CategoryCounter* counter) {
+    unsigned char* buffer;
+    size_t size;
+    if (!category_partial_serialize(counter, &buffer, &size)) {
+        category_counter_free(counter);
+        return PyErr_NoMemory();
+    }
+    category_counter_free(counter);
+    PyObject* result = PyBytes_FromStringAndSize((const char*)buffer, size);
+    free(buffer);
+    return result;
+}
+
+static int merge_partial_objects(PyObject* states, CategoryCounter* counter) {
+    PyObject* seq = PySequence_Fast(states, "Expected a sequence of partial states");
+    if (!seq) return -1;
+    Py_ssize_t k = PySequence_Fast_GET_SIZE(seq);
+    Py_buffer* views = PyMem_Calloc(k ? k : 1, sizeof(Py_buffer));
+    const unsigned char** partials = PyMem_Malloc((k ? k : 1) * sizeof(unsigned char*));
+    size_t* sizes = PyMem_Malloc((k ? k : 1) * sizeof(size_t));
+    int status = -1;
+    Py_ssize_t acquired = 0;
+    if (!views || !partials || !sizes) {
+        PyErr_NoMemory();
+        goto done;
+    }
+    for (; acquired < k; acquired++) {
+        PyObject* item = PySequence_Fast_GET_ITEM(seq, acquired);
+        if (PyObject_GetBuffer(item, &views[acquired], PyBUF_SIMPLE) < 0) goto done;
+        partials[acquired] = views[acquired].buf;
+        sizes[acquired] = views[acquired].len;
+    }
+    if (!category_partial_merge(partials, sizes, k, counter)) {
+        PyErr_SetString(PyExc_ValueError, "Malformed or unsorted partial state");
+        goto done;
+    }
+    status = 0;
+done:
+    for (Py_ssize_t i = 0; i < acquired; i++) PyBuffer_Release(&views[i]);
+    PyMem_Free(views);
+    PyMem_Free(partials);
+    PyMem_Free(sizes);
+    Py_DECREF(seq);
+    return status;
+}
+
+static PyObject* PyCategoryTokenizer_partial_fit(PyCategoryTokenizer* self, PyObject* args) {
+    PyObject* values;
+    if (!PyArg_ParseTuple(args, "O", &values)) return NULL;
+    PyObject* seq = PySequence_Fast(values, "Expected a sequence");
+    if (!seq) return NULL;
+    Py_ssize_t len = PySequence_Fast_GET_SIZE(seq);
+    CategoryCounter counter;
+    category_counter_init(&counter);
+    for (Py_ssize_t i = 0; i < len; i++) {
+        PyObject* item = PySequence_Fast_GET_ITEM(seq, i);
+        const char* value = PyUnicode_AsUTF8(item);
+        if (!value) {
+            category_counter_free(&counter);
+            Py_DECREF(seq);
+            return NULL;
+        }
+        if (!category_counter_add(&counter, value, 1)) {
+            category_counter_free(&counter);
+            Py_DECREF(seq);
+            return PyErr_NoMemory();
+        }
+    }
     Py_DECREF(seq);
+    if (!category_counter_sort(&counter)) {
+        category_counter_free(&counter);
+        return PyErr_NoMemory();
+    }
+    return counter_to_bytes(&counter);
+}
+
+static PyObject* PyCategoryTokenizer_merge_partials(PyCategoryTokenizer* self, PyObject* args) {
+    PyObject* states;
+    if (!PyArg_ParseTuple(args, "O", &states)) return NULL;
+    CategoryCounter counter;
+    if (merge_partial_objects(states, &counter) < 0) return NULL;
+    return counter_to_bytes(&counter);
+}
+
+static PyObject* PyCategoryTokenizer_fit_partials(PyCategoryTokenizer* self, PyObject* args) {
+    PyObject* states;
+    if (!PyArg_ParseTuple(args, "O", &states)) return NULL;
+    CategoryCounter counter;
+    if (merge_partial_objects(states, &counter) < 0) return NULL;
+    category_fit_counter(&self->tokenizer, &counter);
+    category_counter_free(&counter);
     Py_RETURN_NONE;
 }
 
-static PyObject* PyCategoryTokenizer_encode(PyCategoryTokenizer* self, PyObject* args) {
+static PyObject* PyCategoryTokenizer_encode(PyCategoryTokenizer* self, PyObject* args, PyObject* kwds) {
+    static char* kwlist[] = {"values", "validity", NULL};
     PyObject* input;
-    if (!PyArg_ParseTuple(args, "O", &input)) return NULL;
+    PyObject* validity = Py_None;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|O", kwlist, &input, &validity)) return NULL;
 
     // Initialize NumPy API (only once)
     import_array();
@@ -330,10 +1223,11 @@ static PyObject* PyCategoryTokenizer_encode(PyCategoryTokenizer* self, PyObject*
         numpy_initialized = 1;
     }
 
-    if (PyUnicode_Check(input)) {
+    if (PyUnicode_Check(input) || input == Py_None) {
         // Single string case - return 1D numpy array with single element
-        const char* value = PyUnicode_AsUTF8(input);
-        int token = category_encode(&self->tokenizer, value);
+        const char* value = input == Py_None ? NULL : PyUnicode_AsUTF8(input);
+        if (!value && PyErr_Occurred()) return NULL;
+        int token = value ? category_encode(&self->tokenizer, value) : self->tokenizer.offset;
         
         npy_intp dims[1] = {1};
         PyObject* np_array = PyArray_SimpleNew(1, dims, NPY_INT32);
@@ -344,34 +1238,68 @@ static PyObject* PyCategoryTokenizer_encode(PyCategoryTokenizer* self, PyObject*
         return np_array;
         
     } else if (PySequence_Check(input)) {
-        // Sequence case - return 1D numpy array of tokens
-        Py_ssize_t len = PySequence_Size(input);
-        if (len == -1) return NULL;
-        
-        npy_intp dims[1] = {len};
-        PyObject* np_array = PyArray_SimpleNew(1, dims, NPY_INT32);
-        if (!np_array) return NULL;
-        
-        int* data = (int*)PyArray_DATA((PyArrayObject*)np_array);
-        
+        // Sequence case - collect the distinct string objects, encode them as a
+        // batch, then gather each row's token
+        PyObject* seq = PySequence_Fast(input, "Expected a sequence");
+        if (!seq) return NULL;
+        Py_ssize_t len = PySequence_Fast_GET_SIZE(seq);
+        PyObject** items = PySequence_Fast_ITEMS(seq);
+        PyObject* np_array = NULL;
+        uint8_t* bits;
+        ScratchMark mark = scratch_mark();
+        const char** values = scratch_alloc(len * sizeof(const char*));
+        Py_ssize_t* refs = scratch_alloc(len * sizeof(Py_ssize_t));     // row -> value, -1 if missing
+        int* tokens = scratch_alloc(len * sizeof(int));
+        IdentitySlot* cache = scratch_alloc(sizeof(IdentitySlot) << IDENTITY_CACHE_BITS);
+        if (!values || !refs || !tokens || !cache) {
+            PyErr_NoMemory();
+            goto done;
+        }
+        memset(cache, 0, sizeof(IdentitySlot) << IDENTITY_CACHE_BITS);
+        if (!parse_validity(validity, len, &bits)) goto done;
+
+        // Repeated objects (pandas/pyarrow columns reuse them) resolve with one compare
+        Py_ssize_t num_values = 0, hits = 0;
+        bool probe = true;
         for (Py_ssize_t i = 0; i < len; i++) {
-            PyObject* item = PySequence_GetItem(input, i);
-            if (!item) {
-                Py_DECREF(np_array);
-                return NULL;
+            PyObject* item = items[i];
+            if (i == IDENTITY_CACHE_TRIAL && hits < IDENTITY_CACHE_TRIAL / 8) probe = false;
+            if (!validity_get(bits, i)) {
+                refs[i] = -1;
+                continue;
             }
-            
-            if (!PyUnicode_Check(item)) {
-                Py_DECREF(item);
-                Py_DECREF(np_array);
+            IdentitySlot* slot = probe ? identity_slot(cache, item) : NULL;
+            if (slot && slot->key == item) {
+                refs[i] = slot->index;
+                hits++;
+            } else if (PyUnicode_Check(item)) {
+                values[num_values] = PyUnicode_AsUTF8(item);
+                if (!values[num_values]) goto done;
+                if (slot) {
+                    slot->key = item;
+                    slot->index = num_values;
+                }
+                refs[i] = num_values++;
+            } else if (is_missing(item)) {
+                refs[i] = -1;
+            } else {
                 PyErr_SetString(PyExc_TypeError, "Expected string in sequence");
-                return NULL;
+                goto done;
             }
-            
-            const char* value = PyUnicode_AsUTF8(item);
-            data[i] = category_encode(&self->tokenizer, value);
-            Py_DECREF(item);
         }
+
+        npy_intp dims[1] = {len};
+        np_array = PyArray_SimpleNew(1, dims, NPY_INT32);
+        if (np_array) {
+            category_encode_batch(&self->tokenizer, values, NULL, num_values, tokens);
+            int* out = PyArray_DATA((PyArrayObject*)np_array);
+            int missing = self->tokenizer.offset;
+            for (Py_ssize_t i = 0; i < len; i++) out[i] = refs[i] < 0 ? missing : tokens[refs[i]];
+        }
+
+    done:
+        scratch_release_to(mark);
+        Py_DECREF(seq);
         return np_array;
     } else {
         PyErr_SetString(PyExc_TypeError, "Expected string or sequence of strings");
@@ -379,9 +1307,12 @@ static PyObject* PyCategoryTokenizer_encode(PyCategoryTokenizer* self, PyObject*
     }
 }
 
-static PyObject* PyCategoryTokenizer_decode(PyCategoryTokenizer* self, PyObject* args) {
+static PyObject* PyCategoryTokenizer_decode(PyCategoryTokenizer* self, PyObject* args, PyObject* kwds) {
+    static char* kwlist[] = {"tokens", "lazy", NULL};
     PyObject* input;
-    if (!PyArg_ParseTuple(args, "O", &input)) return NULL;
+    int lazy = 0;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|p", kwlist, &input, &lazy)) return NULL;
+    if (lazy && !PyLong_Check(input)) return decoded_view_new((PyObject*)self, input, VIEW_CATEGORY);
     if (PyLong_Check(input)) {
         int token = PyLong_AsLong(input);
         const char* value = category_decode(&self->tokenizer, token);
@@ -404,6 +1335,156 @@ static PyObject* PyCategoryTokenizer_decode(PyCategoryTokenizer* self, PyObject*
     }
 }
 
+static PyObject* PyCategoryTokenizer_freeze(PyCategoryTokenizer* self, PyObject* Py_UNUSED(ignored)) {
+    if (!self->tokenizer.fitted) {
+        PyErr_SetString(PyExc_ValueError, "Tokenizer is not fitted");
+        return NULL;
+    }
+    unsigned char* buffer;
+    size_t size;
+    if (!category_freeze(&self->tokenizer, &buffer, &size)) return PyErr_NoMemory();
+    PyObject* result = PyBytes_FromStringAndSize((const char*)buffer, size);
+    free(buffer);
+    return result;
+}
+
+// --- Methods: decode_logits ---
+static PyObject* PyCategoryTokenizer_decode_logits(PyCategoryTokenizer* self, PyObject* args, PyObject* kwds) {
+    static char* kwlist[] = {"logits", "output", "k", NULL};
+    PyObject* input;
+    const char* output = "string";
+    Py_ssize_t k = 1;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|sn", kwlist, &input, &output, &k)) return NULL;
+    bool strings = strcmp(output, "string") == 0;
+    if (!strings && strcmp(output, "tokens") != 0) {
+        PyErr_SetString(PyExc_ValueError, "output must be 'string' or 'tokens'");
+        return NULL;
+    }
+    const CategoryTokenizer* t = &self->tokenizer;
+    if (!t->fitted) {
+        PyErr_SetString(PyExc_ValueError, "Tokenizer is not fitted");
+        return NULL;
+    }
+    if (k < 1 || (size_t)k > t->num_categories) {
+        PyErr_SetString(PyExc_ValueError, "k must be between 1 and the number of categories");
+        return NULL;
+    }
+    PyArrayObject* logits = logits_matrix(input, (npy_intp)t->offset + 2 + t->num_categories);
+    if (!logits) return NULL;
+
+    npy_intp dims[2] = {PyArray_DIM(logits, 0), k};
+    PyArrayObject* tokens = (PyArrayObject*)PyArray_SimpleNew(k == 1 ? 1 : 2, dims, NPY_INT32);
+    if (!tokens) {
+        Py_DECREF(logits);
+        return NULL;
+    }
+    Py_BEGIN_ALLOW_THREADS
+    category_decode_logits(t, PyArray_DATA(logits), (size_t)dims[0], (size_t)PyArray_DIM(logits, 1),
+                           (size_t)k, PyArray_DATA(tokens));
+    Py_END_ALLOW_THREADS
+    Py_DECREF(logits);
+    if (!strings) return (PyObject*)tokens;
+
+    // One string object per category, shared by every row that chose it
+    const int* data = PyArray_DATA(tokens);
+    size_t num_slots = t->num_categories;
+    PyObject** cache = PyMem_Calloc(num_slots, sizeof(PyObject*));
+    PyObject* result = cache ? PyList_New(dims[0]) : PyErr_NoMemory();
+    for (npy_intp r = 0; result && r < dims[0]; r++) {
+        PyObject* row = k == 1 ? NULL : PyList_New(k);
+        if (k > 1 && !row) {
+            Py_CLEAR(result);
+            break;
+        }
+        for (Py_ssize_t j = 0; j < k; j++) {
+            int token = data[r * k + j];
+            size_t slot = (size_t)(token - (t->offset + 2));
+            PyObject* value;
+            if (token >= t->offset + 2 && slot < num_slots) {
+                if (!cache[slot]) cache[slot] = PyUnicode_FromString(t->categories[slot]);
+                value = cache[slot];
+                Py_XINCREF(value);
+            } else {
+                value = PyUnicode_FromString(category_decode(t, token));
+            }
+            if (!value) {
+                Py_XDECREF(row);
+                Py_CLEAR(result);
+                break;
+            }
+            if (k == 1) {
+                PyList_SET_ITEM(result, r, value);
+            } else {
+                PyList_SET_ITEM(row, j, value);
+            }
+        }
+        if (result && k > 1) PyList_SET_ITEM(result, r, row);
+    }
+    if (cache) {
+        for (size_t i = 0; i < num_slots; i++) Py_XDECREF(cache[i]);
+        PyMem_Free(cache);
+    }
+    Py_DECREF(tokens);
+    return result;
+}
+
+// --- Methods: embed ---
+static PyObject* PyCategoryTokenizer_embed(PyCategoryTokenizer* self, PyObject* args, PyObject* kwds) {
+    static char* kwlist[] = {"values", "table", "pooling", NULL};
+    PyObject* input;
+    PyObject* table_obj;
+    const char* pooling_name = "sum";
+    EmbedPooling pooling;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "OO|s", kwlist, &input, &table_obj, &pooling_name))
+        return NULL;
+    if (!parse_pooling(pooling_name, &pooling)) return NULL;
+
+    const CategoryTokenizer* t = &self->tokenizer;
+    PyArrayObject* table = embed_table(table_obj, (npy_intp)t->offset + t->num_categories + 2);
+    if (!table) return NULL;
+    PyObject* seq = PySequence_Fast(input, "Expected a sequence of strings");
+    if (!seq) {
+        Py_DECREF(table);
+        return NULL;
+    }
+    Py_ssize_t len = PySequence_Fast_GET_SIZE(seq);
+    PyObject** items = PySequence_Fast_ITEMS(seq);
+    size_t num_rows = (size_t)PyArray_DIM(table, 0);
+    size_t dim = (size_t)PyArray_DIM(table, 1);
+    npy_intp dims[2] = {len, (npy_intp)dim};
+    PyArrayObject* out = (PyArrayObject*)PyArray_SimpleNew(2, dims, NPY_FLOAT32);
+    for (Py_ssize_t i = 0; out && i < len; i++) {
+        bool missing = !PyUnicode_Check(items[i]) && is_missing(items[i]);
+        const char* value = PyUnicode_Check(items[i]) ? PyUnicode_AsUTF8(items[i]) : NULL;
+        if (!value && !missing) {
+            if (!PyErr_Occurred()) PyErr_SetString(PyExc_TypeError, "Expected string in sequence");
+            Py_CLEAR(out);
+            break;
+        }
+        // One token per value, so its row is copied (or zeroed) straight into the output
+        int token = missing ? t->offset : category_encode(t, value);
+        embed_tokens(PyArray_DATA(table), num_rows, dim, &token, 1, (float*)PyArray_DATA(out) + i * dim, pooling);
+    }
+    Py_DECREF(seq);
+    Py_DECREF(table);
+    return (PyObject*)out;
+}
+
+// --- Methods: memory_usage, shrink_to_fit ---
+static PyObject* PyCategoryTokenizer_memory_usage(PyCategoryTokenizer* self, PyObject* Py_UNUSED(ignored)) {
+    static const char* const names[] = {"strings", "index", "filter"};
+    CategoryMemoryUsage usage;
+    category_memory_usage(&self->tokenizer, &usage);
+    size_t bytes[] = {usage.strings, usage.index, usage.filter};
+    return memory_usage_dict((PyObject*)self, names, bytes, 3);
+}
+
+static PyObject* PyCategoryTokenizer_shrink_to_fit(PyCategoryTokenizer* self, PyObject* Py_UNUSED(ignored)) {
+    if (!category_shrink_to_fit(&self->tokenizer)) return PyErr_NoMemory();
+    scratch_release();
+    Py_RETURN_NONE;
+}
+
 // --- Getters ---
 static PyObject* PyCategoryTokenizer_get_num_bits(PyCategoryTokenizer* self, void* closure) {
     return PyLong_FromLong(self->tokenizer.fitted ? self->tokenizer.num_categories + 2 : -1);
@@ -413,15 +1494,48 @@ static PyObject* PyCategoryTokenizer_get_num_categories(PyCategoryTokenizer* sel
     return PyLong_FromLong(self->tokenizer.fitted ? self->tokenizer.num_categories : -1);
 }
 
+static PyObject* PyCategoryTokenizer_get_bloom_fpr(PyCategoryTokenizer* self, void* closure) {
+    return PyFloat_FromDouble(self->tokenizer.bloom_fpr);
+}
+
+static PyObject* PyCategoryTokenizer_get_order(PyCategoryTokenizer* self, void* closure) {
+    return PyUnicode_FromString(self->tokenizer.order == CATEGORY_ORDER_FREQUENCY ? "frequency" : "sorted");
+}
+
 static PyObject* PyCategoryTokenizer_get_max_active_features(PyCategoryTokenizer* self, void* closure) {
     return PyLong_FromLong(3);  // 2 sentinels + 1 active category
 }
 
+static PyObject* PyCategoryTokenizer_get_categories(PyCategoryTokenizer* self, void* closure) {
+    const CategoryTokenizer* t = &self->tokenizer;
+    size_t n = t->fitted ? t->num_categories : 0;
+    PyObject* categories = PyTuple_New((Py_ssize_t)n);
+    if (!categories) return NULL;
+    for (size_t i = 0; i < n; i++) {
+        PyObject* value = PyUnicode_FromString(t->categories[i]);
+        if (!value) {
+            Py_DECREF(categories);
+            return NULL;
+        }
+        PyTuple_SET_ITEM(categories, (Py_ssize_t)i, value);
+    }
+    return categories;
+}
+
 // --- Method Table & Type ---
 static PyMethodDef PyCategoryTokenizer_methods[] = {
     {"fit", (PyCFunction)PyCategoryTokenizer_fit, METH_VARARGS, "Fit to categories"},
-    {"encode", (PyCFunction)PyCategoryTokenizer_encode, METH_VARARGS, "Encode values"},
-    {"decode", (PyCFunction)PyCategoryTokenizer_decode, METH_VARARGS, "Decode tokens"},
+    {"fit_chunks", (PyCFunction)PyCategoryTokenizer_fit_chunks, METH_VARARGS | METH_KEYWORDS, "Fit to an iterable of chunks"},
+    {"partial_fit", (PyCFunction)PyCategoryTokenizer_partial_fit, METH_VARARGS, "Serialize a partial fit state"},
+    {"merge_partials", (PyCFunction)PyCategoryTokenizer_merge_partials, METH_VARARGS, "Merge partial fit states"},
+    {"fit_partials", (PyCFunction)PyCategoryTokenizer_fit_partials, METH_VARARGS, "Fit from partial fit states"},
+    {"freeze", (PyCFunction)PyCategoryTokenizer_freeze, METH_NOARGS, "Compile a frozen vocabulary"},
+    {"encode", (PyCFunction)PyCategoryTokenizer_encode, METH_VARARGS | METH_KEYWORDS, "Encode values"},
+    {"decode", (PyCFunction)PyCategoryTokenizer_decode, METH_VARARGS | METH_KEYWORDS, "Decode tokens"},
+    {"decode_logits", (PyCFunction)PyCategoryTokenizer_decode_logits, METH_VARARGS | METH_KEYWORDS, "Decode model logits"},
+    {"embed", (PyCFunction)PyCategoryTokenizer_embed, METH_VARARGS | METH_KEYWORDS, "Encode and pool embedding rows"},
+    {"memory_usage", (PyCFunction)PyCategoryTokenizer_memory_usage, METH_NOARGS, "Bytes held, by structure"},
+    {"shrink_to_fit", (PyCFunction)PyCategoryTokenizer_shrink_to_fit, METH_NOARGS, "Release unused capacity"},
     {NULL}
 };
 
@@ -429,6 +1543,9 @@ static PyGetSetDef PyCategoryTokenizer_getset[] = {
     {"num_bits", (getter)PyCategoryTokenizer_get_num_bits, NULL, "Number of bits (+2 sentinels)", NULL},
     {"num_categories", (getter)PyCategoryTokenizer_get_num_categories, NULL, "Number of categories", NULL},
     {"max_active_features", (getter)PyCategoryTokenizer_get_max_active_features, NULL, "Maximum active features", NULL},
+    {"bloom_fpr", (getter)PyCategoryTokenizer_get_bloom_fpr, NULL, "False positive rate of the unknown filter (0 = disabled)", NULL},
+    {"categories", (getter)PyCategoryTokenizer_get_categories, NULL, "Categories in token order", NULL},
+    {"order", (getter)PyCategoryTokenizer_get_order, NULL, "How fit assigns token ids", NULL},
     {NULL}
 };
 
@@ -446,6 +1563,138 @@ static PyTypeObject PyCategoryTokenizerType = {
     .tp_new = PyCategoryTokenizer_new
 };
 
+// =====================
+// FrozenVocabulary Class
+// =====================
+typedef struct __attribute__((aligned(8))) {
+    PyObject_HEAD
+    Py_buffer view;
+    bool has_view;
+} PyFrozenVocabulary;
+
+// --- Dealloc, Init ---
+static void PyFrozenVocabulary_dealloc(PyFrozenVocabulary* self) {
+    if (self->has_view) PyBuffer_Release(&self->view);
+    Py_TYPE(self)->tp_free((PyObject*)self);
+}
+
+static int PyFrozenVocabulary_init(PyFrozenVocabulary* self, PyObject* args, PyObject* kwds) {
+    static char* kwlist[] = {"buffer", NULL};
+    PyObject* buffer;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O", kwlist, &buffer))
+        return -1;
+    if (self->has_view) {
+        PyBuffer_Release(&self->view);
+        self->has_view = false;
+    }
+    // Holds the exporter (bytes, mmap, ...) alive for the lifetime of the view
+    if (PyObject_GetBuffer(buffer, &self->view, PyBUF_SIMPLE) < 0) return -1;
+    self->has_view = true;
+    if (!frozen_validate(self->view.buf, self->view.len)) {
+        PyErr_SetString(PyExc_ValueError, "Not a frozen vocabulary");
+        return -1;
+    }
+    return 0;
+}
+
+// --- Methods: encode ---
+static PyObject* PyFrozenVocabulary_encode(PyFrozenVocabulary* self, PyObject* args, PyObject* kwds) {
+    static char* kwlist[] = {"values", "validity", NULL};
+    PyObject* input;
+    PyObject* validity = Py_None;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|O", kwlist, &input, &validity)) return NULL;
+    if (!self->has_view) {
+        PyErr_SetString(PyExc_ValueError, "Frozen vocabulary is not initialized");
+        return NULL;
+    }
+    int missing = frozen_offset(self->view.buf);
+
+    if (PyUnicode_Check(input) || input == Py_None) {
+        const char* value = input == Py_None ? NULL : PyUnicode_AsUTF8(input);
+        if (!value && PyErr_Occurred()) return NULL;
+        npy_intp dims[1] = {1};
+        PyObject* np_array = PyArray_SimpleNew(1, dims, NPY_INT32);
+        if (!np_array) return NULL;
+        int* data = (int*)PyArray_DATA((PyArrayObject*)np_array);
+        data[0] = value ? frozen_encode(self->view.buf, value) : missing;
+        return np_array;
+
+    } else if (PySequence_Check(input)) {
+        PyObject* seq = PySequence_Fast(input, "Expected a sequence");
+        if (!seq) return NULL;
+        Py_ssize_t len = PySequence_Fast_GET_SIZE(seq);
+        PyObject** items = PySequence_Fast_ITEMS(seq);
+        ScratchMark mark = scratch_mark();
+        PyObject* np_array = NULL;
+        uint8_t* bits;
+        if (!parse_validity(validity, len, &bits)) goto done;
+        npy_intp dims[1] = {len};
+        np_array = PyArray_SimpleNew(1, dims, NPY_INT32);
+        if (!np_array) goto done;
+        int* data = (int*)PyArray_DATA((PyArrayObject*)np_array);
+        for (Py_ssize_t i = 0; i < len; i++) {
+            if (!validity_get(bits, i)) {
+                data[i] = missing;      // masked rows are never read
+            } else if (PyUnicode_Check(items[i])) {
+                const char* value = PyUnicode_AsUTF8(items[i]);
+                if (!value) {
+                    Py_CLEAR(np_array);
+                    goto done;
+                }
+                data[i] = frozen_encode(self->view.buf, value);
+            } else if (is_missing(items[i])) {
+                data[i] = missing;
+            } else {
+                PyErr_SetString(PyExc_TypeError, "Expected string in sequence");
+                Py_CLEAR(np_array);
+                goto done;
+            }
+        }
+    done:
+        scratch_release_to(mark);
+        Py_DECREF(seq);
+        return np_array;
+    } else {
+        PyErr_SetString(PyExc_TypeError, "Expected string or sequence of strings");
+        return NULL;
+    }
+}
+
+// --- Getters ---
+static PyObject* PyFrozenVocabulary_get_num_categories(PyFrozenVocabulary* self, void* closure) {
+    return PyLong_FromSize_t(self->has_view ? frozen_num_categories(self->view.buf) : 0);
+}
+
+static PyObject* PyFrozenVocabulary_get_nbytes(PyFrozenVocabulary* self, void* closure) {
+    return PyLong_FromSsize_t(self->has_view ? self->view.len : 0);
+}
+
+// --- Method Table & Type ---
+static PyMethodDef PyFrozenVocabulary_methods[] = {
+    {"encode", (PyCFunction)PyFrozenVocabulary_encode, METH_VARARGS | METH_KEYWORDS, "Encode values"},
+    {NULL}
+};
+
+static PyGetSetDef PyFrozenVocabulary_getset[] = {
+    {"num_categories", (getter)PyFrozenVocabulary_get_num_categories, NULL, "Number of categories", NULL},
+    {"nbytes", (getter)PyFrozenVocabulary_get_nbytes, NULL, "Size of the artifact in bytes", NULL},
+    {NULL}
+};
+
+static PyTypeObject PyFrozenVocabularyType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "zeichenformer.FrozenVocabulary",
+    .tp_basicsize = sizeof(PyFrozenVocabulary),
+    .tp_itemsize = 0,
+    .tp_dealloc = (destructor)PyFrozenVocabulary_dealloc,
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_doc = "Encode-only minimal perfect hash view of a fitted category vocabulary",
+    .tp_methods = PyFrozenVocabulary_methods,
+    .tp_getset = PyFrozenVocabulary_getset,
+    .tp_init = (initproc)PyFrozenVocabulary_init,
+    .tp_new = PyType_GenericNew
+};
+
 // =====================
 // TimestampTokenizer Class
 // =====================
@@ -477,9 +1726,26 @@ static int PyTimestampTokenizer_init(PyTimestampTokenizer* self, PyObject* args,
 }
 
 // --- Methods: encode, decode ---
-static PyObject* PyTimestampTokenizer_encode(PyTimestampTokenizer* self, PyObject* args) {
+// Year, month, day, hour, minute and second of a datetime.date or datetime.datetime
+// (midnight for dates); the fields are read directly, without isoformat()
+static void datetime_fields(PyObject* value, int* fields) {
+    fields[0] = PyDateTime_GET_YEAR(value);
+    fields[1] = PyDateTime_GET_MONTH(value);
+    fields[2] = PyDateTime_GET_DAY(value);
+    bool has_time = PyDateTime_Check(value);
+    fields[3] = has_time ? PyDateTime_DATE_GET_HOUR(value) : 0;
+    fields[4] = has_time ? PyDateTime_DATE_GET_MINUTE(value) : 0;
+    fields[5] = has_time ? PyDateTime_DATE_GET_SECOND(value) : 0;
+}
+
+static PyObject* PyTimestampTokenizer_encode(PyTimestampTokenizer* self, PyObject* args, PyObject* kwds) {
+    static char* kwlist[] = {"values", "dedup", "validity", NULL};
     PyObject* input;
-    if (!PyArg_ParseTuple(args, "O", &input)) return NULL;
+    PyObject* dedup = Py_None;
+    PyObject* validity = Py_None;
+    DedupMode mode;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|OO", kwlist, &input, &dedup, &validity)) return NULL;
+    if (!parse_dedup(dedup, &mode)) return NULL;
     
     // Import numpy array type (only done once)
     static PyObject* numpy_module = NULL;
@@ -491,11 +1757,20 @@ static PyObject* PyTimestampTokenizer_encode(PyTimestampTokenizer* self, PyObjec
         if (!array_type) return NULL;
     }
 
-    if (PyUnicode_Check(input)) {
-        // Single string case
-        const char* iso = PyUnicode_AsUTF8(input);
-        int tokens[6], count;
-        timestamp_encode(&self->tokenizer, iso, tokens, &count);
+    if (PyUnicode_Check(input) || PyDate_Check(input) || is_missing(input)) {
+        // Single string, datetime or missing value case
+        int tokens[6], count = 6;
+        if (is_missing(input)) {
+            timestamp_encode_missing(&self->tokenizer, tokens);
+        } else if (PyDate_Check(input)) {
+            int fields[6];
+            datetime_fields(input, fields);
+            timestamp_encode_fields(&self->tokenizer, fields, tokens);
+        } else {
+            const char* iso = PyUnicode_AsUTF8(input);
+            if (!iso) return NULL;
+            timestamp_encode(&self->tokenizer, iso, tokens, &count);
+        }
         
         // Create numpy array from tokens
         npy_intp dims[1] = {count};
@@ -508,81 +1783,158 @@ static PyObject* PyTimestampTokenizer_encode(PyTimestampTokenizer* self, PyObjec
         return np_array;
         
     } else if (PySequence_Check(input)) {
-        // Sequence case
-        Py_ssize_t len = PySequence_Size(input);
-        if (len <= 0) return NULL;
-        
-        PyObject* result = PyList_New(len);
-        if (!result) return NULL;
-        
+        // Sequence case - collect the strings, encode as a batch, then split into rows
+        PyObject* seq = PySequence_Fast(input, "Expected a sequence");
+        if (!seq) return NULL;
+
+        Py_ssize_t len = PySequence_Fast_GET_SIZE(seq);
+        PyObject** items = PySequence_Fast_ITEMS(seq);
+        PyObject* result = NULL;
+        ScratchMark mark = scratch_mark();
+        const char** isos = scratch_alloc(len * sizeof(const char*));
+        size_t* lengths = scratch_alloc(len * sizeof(size_t));
+        int* tokens = scratch_alloc(len * 6 * sizeof(int));
+        uint8_t* bits;
+        if (!isos || !lengths || !tokens) {
+            PyErr_NoMemory();
+            goto done;
+        }
+        if (!parse_validity(validity, len, &bits)) goto done;
+        // Strings are parsed as one batch. Missing values and datetime objects are
+        // left out through the bitmap; datetimes are then encoded from their fields
+        // (NaT is a datetime, so missing values are checked first).
+        bool has_dates = false;
         for (Py_ssize_t i = 0; i < len; i++) {
-            PyObject* item = PySequence_GetItem(input, i);
-            if (!item) {
-                Py_DECREF(result);
-                return NULL;
-            }
-            
-            if (!PyUnicode_Check(item)) {
-                Py_DECREF(item);
-                Py_DECREF(result);
-                PyErr_SetString(PyExc_TypeError, "Expected string in sequence");
-                return NULL;
+            isos[i] = NULL;
+            lengths[i] = 0;
+            if (PyUnicode_Check(items[i])) {
+                Py_ssize_t size;
+                isos[i] = PyUnicode_AsUTF8AndSize(items[i], &size);
+                if (!isos[i]) goto done;
+                lengths[i] = size;
+            } else if (is_missing(items[i]) || !validity_get(bits, i)) {
+                if (!mark_missing(&bits, len, i)) goto done;
+            } else if (PyDate_Check(items[i])) {
+                if (!mark_missing(&bits, len, i)) goto done;
+                lengths[i] = SIZE_MAX;      // encoded below
+                has_dates = true;
+            } else {
+                PyErr_SetString(PyExc_TypeError, "Expected string or datetime in sequence");
+                goto done;
             }
-            
-            const char* iso = PyUnicode_AsUTF8(item);
-            int tokens[6], count;
-            timestamp_encode(&self->tokenizer, iso, tokens, &count);
-            
-            // Create numpy array for each item
-            npy_intp dims[1] = {count};
+        }
+        if (!timestamp_encode_batch(&self->tokenizer, isos, lengths, bits, len, tokens, mode)) {
+            PyErr_NoMemory();
+            goto done;
+        }
+        for (Py_ssize_t i = 0; has_dates && i < len; i++) {
+            if (lengths[i] != SIZE_MAX) continue;
+            int fields[6];
+            datetime_fields(items[i], fields);
+            timestamp_encode_fields(&self->tokenizer, fields, tokens + 6 * i);
+        }
+
+        result = PyList_New(len);
+        if (!result) goto done;
+        for (Py_ssize_t i = 0; i < len; i++) {
+            npy_intp dims[1] = {6};
             PyObject* np_array = PyArray_SimpleNew(1, dims, NPY_INT32);
             if (!np_array) {
-                Py_DECREF(item);
-                Py_DECREF(result);
-                return NULL;
+                Py_CLEAR(result);
+                goto done;
             }
-            
-            // Copy data
             int* data = (int*)PyArray_DATA((PyArrayObject*)np_array);
-            memcpy(data, tokens, count * sizeof(int));
-            
+            memcpy(data, tokens + 6 * i, 6 * sizeof(int));
             PyList_SET_ITEM(result, i, np_array);
-            Py_DECREF(item);
         }
+
+    done:
+        scratch_release_to(mark);
+        Py_DECREF(seq);
         return result;
     } else {
-        PyErr_SetString(PyExc_TypeError, "Expected string or sequence of strings");
+        PyErr_SetString(PyExc_TypeError, "Expected string, datetime or sequence of them");
         return NULL;
     }
 }
 
-static PyObject* PyTimestampTokenizer_decode(PyTimestampTokenizer* self, PyObject* args) {
+// datetime.datetime of 6 tokens (None unless they form a valid timestamp datetime
+// can hold, so leap seconds are None as well)
+static PyObject* timestamp_to_datetime(const TimestampTokenizer* t, const int* tokens, int count) {
+    int f[6];
+    if (!timestamp_decode_fields(t, tokens, count, f) || f[0] < 1 || f[0] > 9999 || f[5] > 59) Py_RETURN_NONE;
+    return PyDateTime_FromDateAndTime(f[0], f[1], f[2], f[3], f[4], f[5], 0);
+}
+
+static PyObject* PyTimestampTokenizer_decode(PyTimestampTokenizer* self, PyObject* args, PyObject* kwds) {
+    static char* kwlist[] = {"tokens", "lazy", "output", NULL};
     PyObject* input;
-    if (!PyArg_ParseTuple(args, "O", &input)) return NULL;
+    int lazy = 0;
+    const char* output_name = "string";
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|ps", kwlist, &input, &lazy, &output_name)) return NULL;
+    bool as_datetime = strcmp(output_name, "datetime") == 0;
+    if (!as_datetime && strcmp(output_name, "string") != 0) {
+        PyErr_Format(PyExc_ValueError, "Unknown output '%s' (expected 'string' or 'datetime')", output_name);
+        return NULL;
+    }
+    if (lazy && as_datetime) {
+        PyErr_SetString(PyExc_ValueError, "lazy decoding only produces strings");
+        return NULL;
+    }
+    if (lazy) return decoded_view_new((PyObject*)self, input, VIEW_TIMESTAMP);
     if (PySequence_Check(input)) {
         Py_ssize_t len = PySequence_Size(input);
         if (len <= 0) return NULL;
         PyObject* result = PyList_New(len);
+        if (!result) return NULL;
+        ScratchMark mark = scratch_mark();
+        int* tokens = NULL;
+        Py_ssize_t capacity = 0;
         for (Py_ssize_t i = 0; i < len; i++)
         {
             PyObject* item = PySequence_GetItem(input, i);
+            if (!item) goto error;
             // assume list of numpy arrays
             if(PySequence_Check(item))
             {
                 Py_ssize_t len2 = PySequence_Size(item);
-                int tokens[len2];
+                tokens = len2 >= 0 ? scratch_ints(tokens, &capacity, len2) : NULL;
+                if (!tokens) {
+                    Py_DECREF(item);
+                    if (!PyErr_Occurred()) PyErr_NoMemory();
+                    goto error;
+                }
                 for (Py_ssize_t j = 0; j < len2; j++) {
                     PyObject* token = PySequence_GetItem(item, j);
+                    if (!token) {
+                        Py_DECREF(item);
+                        goto error;
+                    }
                     tokens[j] = PyLong_AsLong(token);
                     Py_DECREF(token);
                 }
-                char output[64];
-                timestamp_decode(&self->tokenizer, tokens, len2, output);
-                PyList_SET_ITEM(result, i, PyUnicode_FromString(output));
-                Py_DECREF(item);
+                PyObject* value;
+                if (as_datetime) {
+                    value = timestamp_to_datetime(&self->tokenizer, tokens, len2);
+                } else {
+                    char output[64];
+                    timestamp_decode(&self->tokenizer, tokens, len2, output);
+                    value = PyUnicode_FromString(output);
+                }
+                if (!value) {
+                    Py_DECREF(item);
+                    goto error;
+                }
+                PyList_SET_ITEM(result, i, value);
             }
+            Py_DECREF(item);
         }
+        scratch_release_to(mark);
         return result;
+    error:
+        scratch_release_to(mark);
+        Py_DECREF(result);
+        return NULL;
     } else {
         PyErr_SetString(PyExc_TypeError, "Expected sequence");
         return NULL;
@@ -600,16 +1952,167 @@ static PyObject* PyTimestampTokenizer_get_max_active_features(PyTimestampTokeniz
     return PyLong_FromLong(6);  // 6 active features
 }
 
+static PyObject* PyTimestampTokenizer_get_min_year(PyTimestampTokenizer* self, void* closure) {
+    return PyLong_FromLong(self->tokenizer.min_year);
+}
+
+static PyObject* PyTimestampTokenizer_get_max_year(PyTimestampTokenizer* self, void* closure) {
+    return PyLong_FromLong(self->tokenizer.max_year);
+}
+
+static PyObject* PyTimestampTokenizer_get_bucket_offsets(PyTimestampTokenizer* self, void* closure) {
+    const int* o = self->tokenizer.bucket_offsets;
+    return Py_BuildValue("(iiiiii)", o[0], o[1], o[2], o[3], o[4], o[5]);
+}
+
+// --- Methods: decode_logits ---
+static PyObject* PyTimestampTokenizer_decode_logits(PyTimestampTokenizer* self, PyObject* args, PyObject* kwds) {
+    static char* kwlist[] = {"logits", "output", "k", NULL};
+    PyObject* input;
+    const char* output = "datetime64";
+    Py_ssize_t k = 1;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|sn", kwlist, &input, &output, &k)) return NULL;
+    bool datetimes = strcmp(output, "datetime64") == 0;
+    bool strings = strcmp(output, "string") == 0;
+    if (!datetimes && !strings && strcmp(output, "tokens") != 0) {
+        PyErr_SetString(PyExc_ValueError, "output must be 'datetime64', 'string' or 'tokens'");
+        return NULL;
+    }
+    if (k < 1 || (k > 1 && (datetimes || strings))) {
+        PyErr_SetString(PyExc_ValueError, "k must be positive, and 1 unless output='tokens'");
+        return NULL;
+    }
+    const TimestampTokenizer* t = &self->tokenizer;
+    PyArrayObject* logits = logits_matrix(input, (npy_intp)timestamp_logits_width(t));
+    if (!logits) return NULL;
+
+    npy_intp dims[3] = {PyArray_DIM(logits, 0), 6, k};
+    PyArrayObject* tokens = (PyArrayObject*)PyArray_SimpleNew(k == 1 ? 2 : 3, dims, NPY_INT32);
+    if (!tokens) {
+        Py_DECREF(logits);
+        return NULL;
+    }
+    Py_BEGIN_ALLOW_THREADS
+    timestamp_decode_logits(t, PyArray_DATA(logits), (size_t)dims[0], (size_t)PyArray_DIM(logits, 1),
+                            (size_t)k, PyArray_DATA(tokens));
+    Py_END_ALLOW_THREADS
+    Py_DECREF(logits);
+    if (!datetimes && !strings) return (PyObject*)tokens;
+
+    const int* data = PyArray_DATA(tokens);
+    PyObject* result = NULL;
+    if (datetimes) {
+        PyArray_Descr* descr = NULL;
+        PyObject* name = PyUnicode_FromString("M8[s]");
+        if (name && PyArray_DescrConverter(name, &descr)) {
+            result = PyArray_SimpleNewFromDescr(1, dims, descr);
+            if (result) {
+                int64_t* seconds = PyArray_DATA((PyArrayObject*)result);
+                for (npy_intp r = 0; r < dims[0]; r++) seconds[r] = timestamp_epoch_seconds(t, data + 6 * r);
+            }
+        }
+        Py_XDECREF(name);
+    } else {
+        result = PyList_New(dims[0]);
+        for (npy_intp r = 0; result && r < dims[0]; r++) {
+            char buffer[64];
+            timestamp_decode(t, data + 6 * r, 6, buffer);
+            PyObject* value = PyUnicode_FromString(buffer);
+            if (!value) {
+                Py_CLEAR(result);
+                break;
+            }
+            PyList_SET_ITEM(result, r, value);
+        }
+    }
+    Py_DECREF(tokens);
+    return result;
+}
+
+// --- Methods: embed ---
+static PyObject* PyTimestampTokenizer_embed(PyTimestampTokenizer* self, PyObject* args, PyObject* kwds) {
+    static char* kwlist[] = {"values", "table", "pooling", NULL};
+    PyObject* input;
+    PyObject* table_obj;
+    const char* pooling_name = "sum";
+    EmbedPooling pooling;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "OO|s", kwlist, &input, &table_obj, &pooling_name))
+        return NULL;
+    if (!parse_pooling(pooling_name, &pooling)) return NULL;
+
+    const TimestampTokenizer* t = &self->tokenizer;
+    // A leap second encodes to offset + num_tokens
+    PyArrayObject* table = embed_table(table_obj, (npy_intp)t->offset + t->num_tokens + 1);
+    if (!table) return NULL;
+    // A single value, as encode() takes, embeds to one (dim,) row
+    bool single = PyUnicode_Check(input) || PyDate_Check(input) || is_missing(input);
+    PyObject* seq = single ? PyTuple_Pack(1, input)
+                           : PySequence_Fast(input, "Expected string, datetime or sequence of them");
+    if (!seq) {
+        Py_DECREF(table);
+        return NULL;
+    }
+    Py_ssize_t len = PySequence_Fast_GET_SIZE(seq);
+    PyObject** items = PySequence_Fast_ITEMS(seq);
+    size_t num_rows = (size_t)PyArray_DIM(table, 0);
+    size_t dim = (size_t)PyArray_DIM(table, 1);
+    npy_intp dims[2] = {len, (npy_intp)dim};
+    PyArrayObject* out = (PyArrayObject*)PyArray_SimpleNew(single ? 1 : 2, single ? dims + 1 : dims, NPY_FLOAT32);
+    for (Py_ssize_t i = 0; out && i < len; i++) {
+        // Missing values first: NaT is a datetime
+        int tokens[6], count = 6;
+        if (PyUnicode_Check(items[i])) {
+            const char* iso = PyUnicode_AsUTF8(items[i]);
+            if (!iso) {
+                Py_CLEAR(out);
+                break;
+            }
+            timestamp_encode(t, iso, tokens, &count);
+        } else if (is_missing(items[i])) {
+            timestamp_encode_missing(t, tokens);
+        } else if (PyDate_Check(items[i])) {
+            int fields[6];
+            datetime_fields(items[i], fields);
+            timestamp_encode_fields(t, fields, tokens);
+        } else {
+            PyErr_SetString(PyExc_TypeError, "Expected string or datetime in sequence");
+            Py_CLEAR(out);
+            break;
+        }
+        embed_tokens(PyArray_DATA(table), num_rows, dim, tokens, count, (float*)PyArray_DATA(out) + i * dim, pooling);
+    }
+    Py_DECREF(seq);
+    Py_DECREF(table);
+    return (PyObject*)out;
+}
+
+// --- Methods: memory_usage, shrink_to_fit ---
+static PyObject* PyTimestampTokenizer_memory_usage(PyTimestampTokenizer* self, PyObject* Py_UNUSED(ignored)) {
+    return memory_usage_dict((PyObject*)self, NULL, NULL, 0);
+}
+
+static PyObject* PyTimestampTokenizer_shrink_to_fit(PyTimestampTokenizer* self, PyObject* Py_UNUSED(ignored)) {
+    scratch_release();
+    Py_RETURN_NONE;
+}
+
 // --- Method Table & Type ---
 static PyMethodDef PyTimestampTokenizer_methods[] = {
-    {"encode", (PyCFunction)PyTimestampTokenizer_encode, METH_VARARGS, "Encode timestamp"},
-    {"decode", (PyCFunction)PyTimestampTokenizer_decode, METH_VARARGS, "Decode tokens"},
+    {"encode", (PyCFunction)PyTimestampTokenizer_encode, METH_VARARGS | METH_KEYWORDS, "Encode timestamp"},
+    {"decode", (PyCFunction)PyTimestampTokenizer_decode, METH_VARARGS | METH_KEYWORDS, "Decode tokens"},
+    {"decode_logits", (PyCFunction)PyTimestampTokenizer_decode_logits, METH_VARARGS | METH_KEYWORDS, "Decode model logits"},
+    {"embed", (PyCFunction)PyTimestampTokenizer_embed, METH_VARARGS | METH_KEYWORDS, "Encode and pool embedding rows"},
+    {"memory_usage", (PyCFunction)PyTimestampTokenizer_memory_usage, METH_NOARGS, "Bytes held, by structure"},
+    {"shrink_to_fit", (PyCFunction)PyTimestampTokenizer_shrink_to_fit, METH_NOARGS, "Release unused capacity"},
     {NULL}
 };
 
 static PyGetSetDef PyTimestampTokenizer_getset[] = {
     {"num_bits", (getter)PyTimestampTokenizer_get_num_bits, NULL, "Total number of bits", NULL},
     {"max_active_features", (getter)PyTimestampTokenizer_get_max_active_features, NULL, "Total number features active (worst case)", NULL},
+    {"min_year", (getter)PyTimestampTokenizer_get_min_year, NULL, "First year of the range", NULL},
+    {"max_year", (getter)PyTimestampTokenizer_get_max_year, NULL, "Last year of the range", NULL},
+    {"bucket_offsets", (getter)PyTimestampTokenizer_get_bucket_offsets, NULL, "First token of each component", NULL},
     {NULL}
 };
 
@@ -626,6 +2129,496 @@ static PyTypeObject PyTimestampTokenizerType = {
     .tp_new = PyTimestampTokenizer_new
 };
 
+// =====================
+// DecodedView Class
+// =====================
+typedef struct __attribute__((aligned(8))) {
+    PyObject_HEAD
+    PyObject* tokenizer;        // decodes against its current vocabulary
+    PyArrayObject* tokens;      // int32, (n,) for categories or (n, 6) for timestamps
+    ViewKind kind;
+} PyDecodedView;
+
+static PyTypeObject PyDecodedViewType;
+
+static PyObject* decoded_view_new(PyObject* tokenizer, PyObject* tokens, ViewKind kind) {
+    int ndim = kind == VIEW_CATEGORY ? 1 : 2;
+    PyArrayObject* array = (PyArrayObject*)PyArray_FROMANY(
+        tokens, NPY_INT32, ndim, ndim, NPY_ARRAY_IN_ARRAY | NPY_ARRAY_FORCECAST);
+    if (!array) return NULL;
+    if (kind == VIEW_TIMESTAMP && PyArray_DIM(array, 1) != 6) {
+        Py_DECREF(array);
+        PyErr_SetString(PyExc_ValueError, "Expected 6 tokens per timestamp");
+        return NULL;
+    }
+    PyDecodedView* view = PyObject_New(PyDecodedView, &PyDecodedViewType);
+    if (!view) {
+        Py_DECREF(array);
+        return NULL;
+    }
+    Py_INCREF(tokenizer);
+    view->tokenizer = tokenizer;
+    view->tokens = array;
+    view->kind = kind;
+    return (PyObject*)view;
+}
+
+static void PyDecodedView_dealloc(PyDecodedView* self) {
+    Py_XDECREF(self->tokenizer);
+    Py_XDECREF(self->tokens);
+    PyObject_Free(self);
+}
+
+static inline const int* view_row(PyDecodedView* self, Py_ssize_t i) {
+    return (const int*)PyArray_DATA(self->tokens) + i * (self->kind == VIEW_CATEGORY ? 1 : 6);
+}
+
+static PyObject* view_decode(PyDecodedView* self, Py_ssize_t i) {
+    const int* row = view_row(self, i);
+    if (self->kind == VIEW_CATEGORY) {
+        PyCategoryTokenizer* t = (PyCategoryTokenizer*)self->tokenizer;
+        return PyUnicode_FromString(category_decode(&t->tokenizer, row[0]));
+    }
+    PyTimestampTokenizer* t = (PyTimestampTokenizer*)self->tokenizer;
+    char output[64];
+    timestamp_decode(&t->tokenizer, row, 6, output);
+    return PyUnicode_FromString(output);
+}
+
+static Py_ssize_t PyDecodedView_length(PyDecodedView* self) {
+    return PyArray_DIM(self->tokens, 0);
+}
+
+static PyObject* PyDecodedView_item(PyDecodedView* self, Py_ssize_t i) {
+    if (i < 0 || i >= PyArray_DIM(self->tokens, 0)) {
+        PyErr_SetString(PyExc_IndexError, "DecodedView index out of range");
+        return NULL;
+    }
+    return view_decode(self, i);
+}
+
+static PyObject* PyDecodedView_subscript(PyDecodedView* self, PyObject* key) {
+    if (PySlice_Check(key)) {
+        // Slicing the token array is a NumPy view; only the selected rows are kept
+        PyObject* tokens = PyObject_GetItem((PyObject*)self->tokens, key);
+        if (!tokens) return NULL;
+        PyObject* view = decoded_view_new(self->tokenizer, tokens, self->kind);
+        Py_DECREF(tokens);
+        return view;
+    }
+    if (!PyIndex_Check(key)) {
+        PyErr_SetString(PyExc_TypeError, "DecodedView indices must be integers or slices");
+        return NULL;
+    }
+    Py_ssize_t i = PyNumber_AsSsize_t(key, PyExc_IndexError);
+    if (i == -1 && PyErr_Occurred()) return NULL;
+    if (i < 0) i += PyArray_DIM(self->tokens, 0);
+    return PyDecodedView_item(self, i);
+}
+
+// Decode every element; category strings are built once per distinct token
+static PyObject* PyDecodedView_materialize(PyDecodedView* self, PyObject* Py_UNUSED(ignored)) {
+    Py_ssize_t n = PyArray_DIM(self->tokens, 0);
+    PyObject* result = PyList_New(n);
+    if (!result) return NULL;
+    if (self->kind == VIEW_TIMESTAMP) {
+        for (Py_ssize_t i = 0; i < n; i++) {
+            PyObject* value = view_decode(self, i);
+            if (!value) {
+                Py_DECREF(result);
+                return NULL;
+            }
+            PyList_SET_ITEM(result, i, value);
+        }
+        return result;
+    }
+
+    const CategoryTokenizer* t = &((PyCategoryTokenizer*)self->tokenizer)->tokenizer;
+    size_t cache_size = t->fitted ? t->num_categories + 2 : 0;
+    PyObject** cache = PyMem_Calloc(cache_size ? cache_size : 1, sizeof(PyObject*));
+    if (!cache) {
+        Py_DECREF(result);
+        return PyErr_NoMemory();
+    }
+    const int* tokens = view_row(self, 0);
+    for (Py_ssize_t i = 0; i < n; i++) {
+        long slot = (long)tokens[i] - t->offset;
+        PyObject* value;
+        if (slot >= 0 && (size_t)slot < cache_size) {
+            if (!cache[slot]) cache[slot] = PyUnicode_FromString(category_decode(t, tokens[i]));
+            value = cache[slot];
+            Py_XINCREF(value);
+        } else {
+            value = PyUnicode_FromString(category_decode(t, tokens[i]));
+        }
+        if (!value) {
+            Py_CLEAR(result);
+            break;
+        }
+        PyList_SET_ITEM(result, i, value);
+    }
+    for (size_t k = 0; k < cache_size; k++) Py_XDECREF(cache[k]);
+    PyMem_Free(cache);
+    return result;
+}
+
+static PyObject* PyDecodedView_get_tokens(PyDecodedView* self, void* closure) {
+    Py_INCREF(self->tokens);
+    return (PyObject*)self->tokens;
+}
+
+static PyObject* PyDecodedView_repr(PyDecodedView* self) {
+    return PyUnicode_FromFormat("<DecodedView of %zd %s>", PyArray_DIM(self->tokens, 0),
+                                self->kind == VIEW_CATEGORY ? "categories" : "timestamps");
+}
+
+// --- Method Table & Type ---
+static PyMethodDef PyDecodedView_methods[] = {
+    {"materialize", (PyCFunction)PyDecodedView_materialize, METH_NOARGS, "Decode all elements into a list"},
+    {NULL}
+};
+
+static PyGetSetDef PyDecodedView_getset[] = {
+    {"tokens", (getter)PyDecodedView_get_tokens, NULL, "Underlying token array", NULL},
+    {NULL}
+};
+
+static PySequenceMethods PyDecodedView_as_sequence = {
+    .sq_length = (lenfunc)PyDecodedView_length,
+    .sq_item = (ssizeargfunc)PyDecodedView_item,
+};
+
+static PyMappingMethods PyDecodedView_as_mapping = {
+    .mp_length = (lenfunc)PyDecodedView_length,
+    .mp_subscript = (binaryfunc)PyDecodedView_subscript,
+};
+
+static PyTypeObject PyDecodedViewType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "zeichenformer.DecodedView",
+    .tp_basicsize = sizeof(PyDecodedView),
+    .tp_itemsize = 0,
+    .tp_dealloc = (destructor)PyDecodedView_dealloc,
+    .tp_repr = (reprfunc)PyDecodedView_repr,
+    .tp_as_sequence = &PyDecodedView_as_sequence,
+    .tp_as_mapping = &PyDecodedView_as_mapping,
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_doc = "Sequence of decoded values, each decoded on access",
+    .tp_methods = PyDecodedView_methods,
+    .tp_getset = PyDecodedView_getset,
+};
+
+// =====================
+// TokenHistogram Class
+// =====================
+typedef struct __attribute__((aligned(8))) {
+    PyObject_HEAD
+    TokenHistogram histogram;
+} PyTokenHistogram;
+
+#define HISTOGRAM_NOGIL_MIN (1 << 14)   // batches this large count without the GIL
+
+// --- Dealloc, Init ---
+static void PyTokenHistogram_dealloc(PyTokenHistogram* self) {
+    histogram_free(&self->histogram);
+    Py_TYPE(self)->tp_free((PyObject*)self);
+}
+
+static int PyTokenHistogram_init(PyTokenHistogram* self, PyObject* args, PyObject* kwds) {
+    static char* kwlist[] = {"num_tokens", "counts", NULL};
+    Py_ssize_t num_tokens;
+    PyObject* counts = Py_None;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "n|O", kwlist, &num_tokens, &counts))
+        return -1;
+    if (num_tokens < 0 || num_tokens >= INT32_MAX) {
+        PyErr_SetString(PyExc_ValueError, "num_tokens must be in [0, 2^31 - 1)");
+        return -1;
+    }
+    histogram_free(&self->histogram);
+    if (!histogram_init(&self->histogram, (size_t)num_tokens)) {
+        PyErr_NoMemory();
+        return -1;
+    }
+    if (counts == Py_None) return 0;
+
+    // Restore saved counts (optionally with the overflow bin last)
+    PyArrayObject* array = (PyArrayObject*)PyArray_FROM_OTF(counts, NPY_UINT64, NPY_ARRAY_IN_ARRAY | NPY_ARRAY_FORCECAST);
+    if (!array) return -1;
+    npy_intp size = PyArray_SIZE(array);
+    if (size != num_tokens && size != num_tokens + 1) {
+        Py_DECREF(array);
+        PyErr_SetString(PyExc_ValueError, "counts must have num_tokens or num_tokens + 1 entries");
+        return -1;
+    }
+    memcpy(self->histogram.counts, PyArray_DATA(array), size * sizeof(uint64_t));
+    Py_DECREF(array);
+    return 0;
+}
+
+// Current counts of a TokenHistogram or an array of num_tokens counts as a new
+// uint64 array (NULL with an exception set otherwise)
+static PyArrayObject* histogram_counts_of(PyObject* obj, size_t num_tokens);
+
+// --- Methods: update, reset, divergence ---
+static PyObject* PyTokenHistogram_update(PyTokenHistogram* self, PyObject* args) {
+    PyObject* input;
+    if (!PyArg_ParseTuple(args, "O", &input)) return NULL;
+    if (!self->histogram.counts) {
+        PyErr_SetString(PyExc_ValueError, "Histogram is not initialized");
+        return NULL;
+    }
+    PyArrayObject* tokens = (PyArrayObject*)PyArray_FROM_OTF(input, NPY_INT32, NPY_ARRAY_IN_ARRAY | NPY_ARRAY_FORCECAST);
+    if (!tokens) return NULL;
+    size_t n = (size_t)PyArray_SIZE(tokens);
+    const int32_t* data = PyArray_DATA(tokens);
+
+    size_t work_size = histogram_work_size(&self->histogram, n);
+    ScratchMark mark = scratch_mark();
+    void* work = work_size ? scratch_alloc(work_size) : NULL;
+    if (work_size && !work) {
+        Py_DECREF(tokens);
+        return PyErr_NoMemory();
+    }
+    if (n >= HISTOGRAM_NOGIL_MIN) {
+        Py_BEGIN_ALLOW_THREADS
+        histogram_add(&self->histogram, data, n, work);
+        Py_END_ALLOW_THREADS
+    } else {
+        histogram_add(&self->histogram, data, n, work);
+    }
+    scratch_release_to(mark);
+    Py_DECREF(tokens);
+    Py_RETURN_NONE;
+}
+
+static PyObject* PyTokenHistogram_reset(PyTokenHistogram* self, PyObject* Py_UNUSED(ignored)) {
+    if (self->histogram.counts) histogram_clear(&self->histogram);
+    Py_RETURN_NONE;
+}
+
+static PyObject* PyTokenHistogram_divergence(PyTokenHistogram* self, PyObject* args, PyObject* kwds) {
+    static char* kwlist[] = {"reference", "kind", "eps", NULL};
+    PyObject* reference;
+    int kind;
+    double eps = 1e-6;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "Oi|d", kwlist, &reference, &kind, &eps))
+        return NULL;
+    if (kind < DIVERGENCE_PSI || kind > DIVERGENCE_JS) {
+        PyErr_SetString(PyExc_ValueError, "Unknown divergence kind");
+        return NULL;
+    }
+    if (!self->histogram.counts) {
+        PyErr_SetString(PyExc_ValueError, "Histogram is not initialized");
+        return NULL;
+    }
+    PyArrayObject* expected = histogram_counts_of(reference, self->histogram.num_tokens);
+    if (!expected) return NULL;
+    PyArrayObject* actual = histogram_counts_of((PyObject*)self, self->histogram.num_tokens);
+    if (!actual) {
+        Py_DECREF(expected);
+        return NULL;
+    }
+    double value = histogram_divergence(PyArray_DATA(actual), PyArray_DATA(expected),
+                                        self->histogram.num_tokens, (DivergenceKind)kind, eps);
+    Py_DECREF(actual);
+    Py_DECREF(expected);
+    return PyFloat_FromDouble(value);
+}
+
+// --- Getters ---
+static PyObject* PyTokenHistogram_get_counts(PyTokenHistogram* self, void* closure) {
+    return (PyObject*)histogram_counts_of((PyObject*)self, self->histogram.num_tokens);
+}
+
+static PyObject* PyTokenHistogram_get_overflow(PyTokenHistogram* self, void* closure) {
+    if (!self->histogram.counts) return PyLong_FromLong(0);
+    return PyLong_FromUnsignedLongLong(__atomic_load_n(&self->histogram.counts[self->histogram.num_tokens],
+                                                       __ATOMIC_RELAXED));
+}
+
+static PyObject* PyTokenHistogram_get_num_tokens(PyTokenHistogram* self, void* closure) {
+    return PyLong_FromSize_t(self->histogram.num_tokens);
+}
+
+// --- Method Table & Type ---
+static PyMethodDef PyTokenHistogram_methods[] = {
+    {"update", (PyCFunction)PyTokenHistogram_update, METH_VARARGS, "Count a batch of tokens"},
+    {"reset", (PyCFunction)PyTokenHistogram_reset, METH_NOARGS, "Zero all counts"},
+    {"divergence", (PyCFunction)PyTokenHistogram_divergence, METH_VARARGS | METH_KEYWORDS,
+     "Divergence from reference counts"},
+    {NULL}
+};
+
+static PyGetSetDef PyTokenHistogram_getset[] = {
+    {"counts", (getter)PyTokenHistogram_get_counts, NULL, "Count per token", NULL},
+    {"overflow", (getter)PyTokenHistogram_get_overflow, NULL, "Tokens outside the histogram", NULL},
+    {"num_tokens", (getter)PyTokenHistogram_get_num_tokens, NULL, "Number of bins", NULL},
+    {NULL}
+};
+
+static PyTypeObject PyTokenHistogramType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "zeichenformer.TokenHistogram",
+    .tp_basicsize = sizeof(PyTokenHistogram),
+    .tp_itemsize = 0,
+    .tp_dealloc = (destructor)PyTokenHistogram_dealloc,
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_doc = "Concurrent token counts with drift divergences",
+    .tp_methods = PyTokenHistogram_methods,
+    .tp_getset = PyTokenHistogram_getset,
+    .tp_init = (initproc)PyTokenHistogram_init,
+    .tp_new = PyType_GenericNew
+};
+
+static PyArrayObject* histogram_counts_of(PyObject* obj, size_t num_tokens) {
+    npy_intp dims[1] = {(npy_intp)num_tokens};
+    if (PyObject_TypeCheck(obj, &PyTokenHistogramType)) {
+        TokenHistogram* h = &((PyTokenHistogram*)obj)->histogram;
+        if (!h->counts || h->num_tokens != num_tokens) {
+            PyErr_SetString(PyExc_ValueError, "Histograms must have the same number of tokens");
+            return NULL;
+        }
+        PyArrayObject* counts = (PyArrayObject*)PyArray_SimpleNew(1, dims, NPY_UINT64);
+        if (!counts) return NULL;
+        ScratchMark mark = scratch_mark();
+        uint64_t* out = scratch_alloc((num_tokens + 1) * sizeof(uint64_t));
+        if (!out) {
+            Py_DECREF(counts);
+            return (PyArrayObject*)PyErr_NoMemory();
+        }
+        histogram_read(h, out);
+        memcpy(PyArray_DATA(counts), out, num_tokens * sizeof(uint64_t));
+        scratch_release_to(mark);
+        return counts;
+    }
+    PyArrayObject* counts = (PyArrayObject*)PyArray_FROM_OTF(obj, NPY_UINT64,
+                                                             NPY_ARRAY_IN_ARRAY | NPY_ARRAY_FORCECAST | NPY_ARRAY_ENSURECOPY);
+    if (!counts) return NULL;
+    if ((size_t)PyArray_SIZE(counts) != num_tokens) {
+        Py_DECREF(counts);
+        PyErr_SetString(PyExc_ValueError, "Reference counts must have num_tokens entries");
+        return NULL;
+    }
+    return counts;
+}
+
+// =====================
+// Token Stream Codec
+// =====================
+static PyObject* py_compress_tokens(PyObject* module, PyObject* args) {
+    int layout;
+    Py_buffer tokens, counts = {0};
+    PyObject* counts_obj = Py_None;
+    if (!PyArg_ParseTuple(args, "iy*|O", &layout, &tokens, &counts_obj)) return NULL;
+
+    PyObject* result = NULL;
+    if (tokens.len % sizeof(int32_t)) {
+        PyErr_SetString(PyExc_ValueError, "Token buffer length must be a multiple of 4 bytes");
+        goto done;
+    }
+    size_t num_tokens = tokens.len / sizeof(int32_t);
+    size_t num_rows = num_tokens;
+    if (layout == CODEC_BINARY) {
+        if (counts_obj == Py_None) {
+            PyErr_SetString(PyExc_ValueError, "Binary layout requires row counts");
+            goto done;
+        }
+        if (PyObject_GetBuffer(counts_obj, &counts, PyBUF_SIMPLE) < 0) goto done;
+        if (counts.len % sizeof(uint32_t)) {
+            PyErr_SetString(PyExc_ValueError, "Row count buffer length must be a multiple of 4 bytes");
+            goto done;
+        }
+        num_rows = counts.len / sizeof(uint32_t);
+    } else if (layout == CODEC_TIMESTAMP) {
+        if (num_tokens % 6) {
+            PyErr_SetString(PyExc_ValueError, "Timestamp layout requires 6 tokens per row");
+            goto done;
+        }
+        num_rows = num_tokens / 6;
+    } else if (layout != CODEC_CATEGORY) {
+        PyErr_SetString(PyExc_ValueError, "Unknown token layout");
+        goto done;
+    }
+
+    if (layout == CODEC_BINARY) {
+        size_t total = 0;
+        for (size_t i = 0; i < num_rows; i++) total += ((const uint32_t*)counts.buf)[i];
+        if (total != num_tokens) {
+            PyErr_SetString(PyExc_ValueError, "Row counts do not match the number of tokens");
+            goto done;
+        }
+    }
+
+    unsigned char* out = PyMem_Malloc(codec_bound(num_tokens, num_rows));
+    if (!out) {
+        PyErr_NoMemory();
+        goto done;
+    }
+    size_t size;
+    Py_BEGIN_ALLOW_THREADS
+    if (layout == CODEC_CATEGORY) {
+        size = codec_compress_category(tokens.buf, num_rows, out);
+    } else if (layout == CODEC_TIMESTAMP) {
+        size = codec_compress_timestamp(tokens.buf, num_rows, out);
+    } else {
+        size = codec_compress_binary(tokens.buf, counts.buf, num_rows, out);
+    }
+    Py_END_ALLOW_THREADS
+    result = PyBytes_FromStringAndSize((const char*)out, size);
+    PyMem_Free(out);
+
+done:
+    PyBuffer_Release(&tokens);
+    if (counts.obj) PyBuffer_Release(&counts);
+    return result;
+}
+
+static PyObject* py_decompress_tokens(PyObject* module, PyObject* args) {
+    Py_buffer view;
+    if (!PyArg_ParseTuple(args, "y*", &view)) return NULL;
+
+    PyObject* result = NULL;
+    PyObject* tokens = NULL;
+    PyObject* counts = NULL;
+    CodecInfo info;
+    if (!codec_info(view.buf, view.len, &info)) {
+        PyErr_SetString(PyExc_ValueError, "Not a compressed token stream");
+        goto done;
+    }
+    npy_intp token_dims[1] = {(npy_intp)info.num_tokens};
+    tokens = PyArray_SimpleNew(1, token_dims, NPY_INT32);
+    if (!tokens) goto done;
+    if (info.layout == CODEC_BINARY) {
+        npy_intp count_dims[1] = {(npy_intp)info.num_rows};
+        counts = PyArray_SimpleNew(1, count_dims, NPY_UINT32);
+        if (!counts) goto done;
+    }
+
+    bool ok;
+    int32_t* token_data = PyArray_DATA((PyArrayObject*)tokens);
+    uint32_t* count_data = counts ? PyArray_DATA((PyArrayObject*)counts) : NULL;
+    Py_BEGIN_ALLOW_THREADS
+    ok = codec_decompress(view.buf, view.len, token_data, count_data);
+    Py_END_ALLOW_THREADS
+    if (!ok) {
+        PyErr_SetString(PyExc_ValueError, "Corrupt compressed token stream");
+        goto done;
+    }
+    result = Py_BuildValue("iOO", (int)info.layout, tokens, counts ? counts : Py_None);
+
+done:
+    Py_XDECREF(tokens);
+    Py_XDECREF(counts);
+    PyBuffer_Release(&view);
+    return result;
+}
+
+static PyMethodDef _tokenizers_methods[] = {
+    {"compress_tokens", py_compress_tokens, METH_VARARGS, "Compress an int32 token stream"},
+    {"decompress_tokens", py_decompress_tokens, METH_VARARGS, "Decompress a token stream"},
+    {NULL}
+};
+
 // =====================
 // Module Definition
 // =====================
@@ -634,23 +2627,35 @@ static PyModuleDef _tokenizers_module = {
     .m_name = "zeichenformer._tokenizers",
     .m_doc = "High-performance tokenizers",
     .m_size = -1,
+    .m_methods = _tokenizers_methods,
 };
 
 PyMODINIT_FUNC PyInit__tokenizers(void) {
     PyObject* m;
+    PyDateTime_IMPORT;
+    if (!PyDateTimeAPI) return NULL;
     if (PyType_Ready(&PyBinaryTokenizerType) < 0 ||
         PyType_Ready(&PyCategoryTokenizerType) < 0 ||
-        PyType_Ready(&PyTimestampTokenizerType) < 0) {
+        PyType_Ready(&PyFrozenVocabularyType) < 0 ||
+        PyType_Ready(&PyTimestampTokenizerType) < 0 ||
+        PyType_Ready(&PyDecodedViewType) < 0 ||
+        PyType_Ready(&PyTokenHistogramType) < 0) {
         return NULL;
     }
     m = PyModule_Create(&_tokenizers_module);
     if (!m) return NULL;
     Py_INCREF(&PyBinaryTokenizerType);
     Py_INCREF(&PyCategoryTokenizerType);
+    Py_INCREF(&PyFrozenVocabularyType);
     Py_INCREF(&PyTimestampTokenizerType);
+    Py_INCREF(&PyDecodedViewType);
+    Py_INCREF(&PyTokenHistogramType);
     PyModule_AddObject(m, "BinaryTokenizer", (PyObject*)&PyBinaryTokenizerType);
     PyModule_AddObject(m, "CategoryTokenizer", (PyObject*)&PyCategoryTokenizerType);
+    PyModule_AddObject(m, "FrozenVocabulary", (PyObject*)&PyFrozenVocabularyType);
     PyModule_AddObject(m, "TimestampTokenizer", (PyObject*)&PyTimestampTokenizerType);
+    PyModule_AddObject(m, "DecodedView", (PyObject*)&PyDecodedViewType);
+    PyModule_AddObject(m, "TokenHistogram", (PyObject*)&PyTokenHistogramType);
     import_array();
     return m;
 }
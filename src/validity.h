@@ -0,0 +1,61 @@
+#ifndef VALIDITY_H
+#define VALIDITY_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+// Arrow-style validity bitmaps: bit i % 8 of byte i / 8 is set when row i is present.
+// A NULL bitmap means every row is present.
+
+// Bytes of a bitmap covering n rows
+static inline size_t validity_bytes(size_t n) {
+    return (n + 7) / 8;
+}
+
+// Whether row i is present
+static inline bool validity_get(const uint8_t* bits, size_t i) {
+    return !bits || ((bits[i >> 3] >> (i & 7)) & 1);
+}
+
+// Mark row i missing
+static inline void validity_clear(uint8_t* bits, size_t i) {
+    bits[i >> 3] &= (uint8_t)~(1u << (i & 7));
+}
+
+// Rows i..i+63 as one word, row i in the lowest bit (rows past n read as missing)
+static inline uint64_t validity_word(const uint8_t* bits, size_t n, size_t i) {
+    unsigned char buf[9] = {0};
+    size_t byte = i >> 3;
+    size_t avail = validity_bytes(n) - byte;
+    memcpy(buf, bits + byte, avail < sizeof(buf) ? avail : sizeof(buf));
+    uint64_t word;
+    memcpy(&word, buf, sizeof(word));
+    unsigned shift = (unsigned)(i & 7);
+    if (shift) word = (word >> shift) | ((uint64_t)buf[8] << (64 - shift));
+    size_t left = n - i;
+    return left < 64 ? word & ((UINT64_C(1) << left) - 1) : word;
+}
+
+// End of the run of rows sharing the validity of row start, which is stored in
+// *valid. Scans a word at a time, so fully present stretches cost one load per 64 rows.
+static inline size_t validity_run(const uint8_t* bits, size_t n, size_t start, bool* valid) {
+    *valid = validity_get(bits, start);
+    if (!bits) return n;
+    size_t i = start;
+    while (i < n) {
+        uint64_t word = validity_word(bits, n, i);
+        if (!*valid) word = ~word;      // look for the next present row instead
+        size_t left = n - i;
+        uint64_t full = left < 64 ? (UINT64_C(1) << left) - 1 : ~UINT64_C(0);
+        if ((word & full) == full) {
+            i += left < 64 ? left : 64;
+            continue;
+        }
+        return i + (size_t)__builtin_ctzll(~word);
+    }
+    return n;
+}
+
+#endif
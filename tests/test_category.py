@@ -1,7 +1,8 @@
 import numpy as np
+import pytest
 import time
 
-from zeichenformer import CategoryTokenizer
+from zeichenformer import CategoryTokenizer, FrozenVocabulary
 
 def test_basic():
     offset = 9
@@ -38,6 +39,249 @@ def test_basic():
     decoded = tokenizer.decode(encoded)
     assert decoded == original_data
 
+def test_large_batch():
+    # Larger than the default 8 MB stack when staged as a C array of pointers
+    data = ["left", "right"] * 600_000
+    tokenizer = CategoryTokenizer()
+    tokenizer.fit(data)
+    assert tokenizer.num_categories == 2
+
+def test_fit_chunks():
+    data = [f"item_{i % 37}" for i in range(1000)]
+    reference = CategoryTokenizer()
+    reference.fit(data)
+    tokenizer = CategoryTokenizer()
+    tokenizer.fit_chunks(data[i:i + 64] for i in range(0, len(data), 64))
+    assert list(tokenizer.encode(data)) == list(reference.encode(data))
+
+    # A reservoir sample only ever sees values from the stream
+    sampled = CategoryTokenizer()
+    sampled.fit_chunks((data[i:i + 64] for i in range(0, len(data), 64)), sample_size=10)
+    assert 0 < sampled.num_categories <= 10
+    assert all(token > 1 for token in sampled.encode(sampled.decode(list(range(2, 2 + sampled.num_categories)))))
+
+def test_partial_fit():
+    offset = 3
+    data = [
+        "kiwi", "apple", "banana", "apple", "cherry", "fig", "kiwi",
+        "date", "banana", "grape", "apple", "cherry", "elderberry", "", "",
+    ]
+    reference = CategoryTokenizer(offset=offset)
+    reference.fit(data)
+
+    tokenizer = CategoryTokenizer(offset=offset)
+    states = [tokenizer.partial_fit(data[i::3]) for i in range(3)]
+    merged = tokenizer.merge_partials(states[:2])
+    tokenizer.fit_partials([merged, states[2]])
+    assert tokenizer.num_categories == reference.num_categories
+    assert tokenizer.categories == reference.categories and tokenizer.categories[0] == ""
+    assert list(tokenizer.encode(data)) == list(reference.encode(data))
+
+    try:
+        tokenizer.fit_partials([b"not a state"])
+        assert False, "expected ValueError"
+    except ValueError:
+        pass
+
+def test_bloom_filter():
+    offset = 5
+    known = [f"item_{i}" for i in range(500)]
+    unknown = [f"other_{i}" for i in range(500)]
+    reference = CategoryTokenizer(offset=offset)
+    reference.fit(known)
+    tokenizer = CategoryTokenizer(offset=offset, bloom_fpr=0.01)
+    tokenizer.fit(known)
+    assert tokenizer.bloom_fpr == 0.01
+    assert list(tokenizer.encode(known)) == list(reference.encode(known))
+    assert all(token == 1 for token in tokenizer.encode(unknown))
+
+def test_small_vocabulary():
+    # Keys sharing their first 16 bytes must be told apart by the full compare
+    offset = 2
+    data = ["shared_prefix_16" + suffix for suffix in ["", "a", "b", "ab", "ba"]]
+    tokenizer = CategoryTokenizer(offset=offset)
+    tokenizer.fit(data)
+    for i, value in enumerate(sorted(data)):
+        assert tokenizer.encode(value) == i + 2 + offset
+    assert tokenizer.encode("shared_prefix_16c") == 1
+    assert tokenizer.encode("shared_prefix_1") == 1
+
+def test_freeze():
+    offset = 4
+    known = [f"item_{i}" for i in range(1000)]
+    tokenizer = CategoryTokenizer(offset=offset)
+    tokenizer.fit(known)
+    frozen = FrozenVocabulary(tokenizer.freeze())
+    assert frozen.num_categories == 1000
+    assert list(frozen.encode(known)) == list(tokenizer.encode(known))
+    assert list(frozen.encode(["item_1000", "other"])) == [1, 1]
+    with pytest.raises(UnicodeEncodeError):
+        frozen.encode(["item_1", "\udcff"])
+
+    # Missing values match the tokenizer
+    values = ["item_1", None, float("nan"), "", "item_2"]
+    mask = np.array([True, True, True, True, False])
+    assert list(frozen.encode(values)) == list(tokenizer.encode(values))
+    assert list(frozen.encode(values)[1:4]) == [offset] * 3
+    assert list(frozen.encode(values, validity=mask)) == list(tokenizer.encode(values, validity=mask))
+    assert list(frozen.encode(None)) == [offset]
+
+def test_lazy_decode():
+    tokenizer = CategoryTokenizer()
+    tokenizer.fit(["apple", "banana", "cherry"])
+    tokens = tokenizer.encode(["cherry", "apple", "durian", "banana"] * 250)
+    view = tokenizer.decode(tokens, lazy=True)
+    assert len(view) == 1000
+    assert view[0] == "cherry" and view[-1] == "banana" and view[2] == "__unknown__"
+    assert list(view[1:4]) == ["apple", "__unknown__", "banana"]
+    assert list(view[::4]) == ["cherry"] * 250
+    assert view.materialize() == tokenizer.decode(tokens)
+    with pytest.raises(IndexError):
+        view[1000]
+
+def test_memory_usage():
+    categories = [f"category_{i}" for i in range(1000)]
+    tokenizer = CategoryTokenizer()
+    tokenizer.fit(categories * 5)
+    usage = tokenizer.memory_usage()
+    # Fit leaves the arena at its exact size and the index at one pointer per category
+    # plus the search tree (an 8-byte prefix and a 4-byte id per node, from node 1)
+    assert usage['strings'] == sum(len(c) + 1 for c in categories)
+    assert usage['index'] == 8 * len(categories) + 12 * (len(categories) + 1) and usage['filter'] == 0
+    assert usage['total'] == sum(v for k, v in usage.items() if k != 'total')
+
+    tokenizer.shrink_to_fit()
+    assert tokenizer.memory_usage()['scratch'] == 0
+    assert tokenizer.encode(categories[:2]).tolist() == [2, 3]
+
+def test_embed():
+    tokenizer = CategoryTokenizer(offset=1)
+    tokenizer.fit(["a", "b", "c"])
+    table = np.random.normal(size=(tokenizer.offset + tokenizer.num_bits, 8)).astype(np.float32)
+    pooled = tokenizer.embed(["c", "a", "unseen", ""], table)
+    assert np.array_equal(pooled[:3], table[tokenizer.encode(["c", "a", "unseen"])])
+    assert np.array_equal(pooled[3], table[tokenizer.offset])  # the empty string is missing
+    with pytest.raises(ValueError):
+        tokenizer.embed(["a"], table[:2])
+
+def test_decode_logits():
+    tokenizer = CategoryTokenizer(offset=3)
+    tokenizer.fit([f"cat_{i}" for i in range(100)])
+    logits = np.random.normal(size=(500, tokenizer.offset + tokenizer.num_bits)).astype(np.float32)
+    logits[:, :5] = 100.0    # sentinels are never chosen
+    best = np.argmax(logits[:, 5:], axis=1)
+    assert np.array_equal(tokenizer.decode_logits(logits, output='tokens'), best + 5)
+    assert tokenizer.decode_logits(logits) == [tokenizer.categories[i] for i in best]
+    top = tokenizer.decode_logits(logits, output='tokens', k=4)
+    assert np.array_equal(top, np.argsort(-logits[:, 5:], axis=1, kind='stable')[:, :4] + 5)
+
+def test_missing():
+    tokenizer = CategoryTokenizer(offset=3)
+    tokenizer.fit(["apple", "banana", "cherry"])
+    values = ["apple", None, "banana", float("nan"), "durian"] * 40
+    tokens = tokenizer.encode(values)
+    assert list(tokens[:5]) == [5, 3, 6, 3, 1]
+    assert tokenizer.decode(int(tokens[1])) == "__missing__"
+    assert list(tokenizer.encode(None)) == list(tokenizer.encode("")) == [3]
+    assert list(tokenizer.encode(["", "apple"])) == [3, 5]
+
+    # Arrow-style bitmap and boolean mask; masked rows are never read
+    mask = np.arange(200) % 7 != 0
+    bitmap = np.packbits(mask, bitorder='little')
+    masked = [v if m else 12345 for v, m in zip(values, mask)]
+    expected = np.where(mask, tokens, 3)
+    assert np.array_equal(tokenizer.encode(masked, validity=bitmap), expected)
+    assert np.array_equal(tokenizer.encode(masked, validity=mask), expected)
+    assert np.array_equal(tokenizer.encode(values, validity=bytes(bitmap)), expected)
+
+def test_frequency_order():
+    offset = 3
+    counts = {f"item_{i}": 1 + (i * 7919) % 1000 for i in range(500)}
+    data = [value for value, count in counts.items() for _ in range(count)]
+    np.random.shuffle(data)
+    tokenizer = CategoryTokenizer(offset=offset, order="frequency", bloom_fpr=0.01)
+    tokenizer.fit(data)
+    assert tokenizer.order == "frequency"
+    expected = sorted(counts, key=lambda value: (-counts[value], value))
+    assert list(tokenizer.categories) == expected
+
+    # Hot prefix, binary search over the remaining ids and unknowns
+    queries = list(counts) + ["other", ""]
+    tokens = tokenizer.encode(queries)
+    assert list(tokens[:500]) == [expected.index(value) + 2 + offset for value in counts]
+    assert list(tokens[500:]) == [1, offset]
+    assert tokenizer.decode(tokens[:500]) == list(counts)
+
+    # Every fit path numbers the same way
+    chunked = CategoryTokenizer(order="frequency")
+    chunked.fit_chunks(data[i:i + 1000] for i in range(0, len(data), 1000))
+    partials = CategoryTokenizer(order="frequency")
+    partials.fit_partials([partials.partial_fit(data[:7000]), partials.partial_fit(data[7000:])])
+    assert chunked.categories == partials.categories == tokenizer.categories
+
+    small = CategoryTokenizer(order="frequency")
+    small.fit(["b", "a", "b", "c", "c", "b"])
+    assert small.categories == ("b", "c", "a")
+    assert list(small.encode(["a", "b", "c", "d"])) == [4, 2, 3, 1]
+    with pytest.raises(ValueError):
+        CategoryTokenizer(order="random")
+
+def test_identity_cache():
+    offset = 2
+    vocab = [f"value_{i}" for i in range(3000)]
+    tokenizer = CategoryTokenizer(offset=offset)
+    tokenizer.fit(vocab[::2])
+
+    # Shared objects (cache hits), equal but distinct objects and missing rows agree
+    shared = [vocab[i] for i in np.random.randint(0, 40, 10_000)] + [None, "", "value_1"]
+    copies = ["".join(value) if value else value for value in shared]
+    mask = np.random.rand(len(shared)) > 0.1
+    assert list(tokenizer.encode(shared, validity=mask)) == list(tokenizer.encode(copies, validity=mask))
+    expected = [offset if not present or value is None else tokenizer.encode(value)[0]
+                for value, present in zip(copies, mask)]
+    assert list(tokenizer.encode(shared, validity=mask)) == expected
+
+    # Mostly distinct objects stop probing after the trial rows
+    distinct = list(np.random.choice(vocab, 20_000))
+    assert list(tokenizer.encode(distinct)) == [tokenizer.encode(value)[0] for value in distinct]
+
+def test_grouped_search():
+    # Large vocabularies search batches in prefetching groups; rows must match single lookups
+    vocab = [f"{i * 2654435761 % 10**9:09d}" for i in range(140_000)]
+    queries = list(np.random.choice(vocab, 5000)) + ["missing_key", "", "0", "999999999x"]
+    for order in ["sorted", "frequency"]:
+        tokenizer = CategoryTokenizer(offset=1, order=order)
+        tokenizer.fit(vocab + vocab[:100])
+        tokens = tokenizer.encode(queries)
+        assert list(tokens) == [tokenizer.encode(value)[0] for value in queries]
+        assert tokenizer.decode(tokens[:5000]) == queries[:5000]
+
+def test_search_tree():
+    # Keys shorter than, equal to and sharing the 8-byte prefix the tree compares first
+    vocab = sorted({f"prefix__{i}" for i in range(300)} | {"a", "ab", "abcdefgh", "abcdefg", "prefix_", "zz"})
+    tokenizer = CategoryTokenizer()
+    tokenizer.fit(vocab)
+    queries = vocab + ["prefix__", "prefix__300", "abcdefghi", "abc", "0", "\u00ff", "prefix_0"]
+    tokens = tokenizer.encode(queries)
+    assert list(tokens[:len(vocab)]) == list(range(2, 2 + len(vocab)))
+    assert list(tokens[len(vocab):]) == [1] * 7
+    assert list(tokens) == [tokenizer.encode(value)[0] for value in queries]
+
+def test_parallel_sort():
+    # Over STRSORT_PARALLEL_MIN keys: chunks are sorted on threads and merged pairwise.
+    # Long shared prefixes push the multikey recursion deep; multibyte UTF-8 must order
+    # by bytes, like strcmp
+    stems = ["", "shared/prefix/of/some/length/", "café/", "日本語/", "\U0001f600/", "ÿ"]
+    vocab = [f"{stem}{i * 7919 % 12_000:05d}" for i in range(12_000) for stem in stems]
+    vocab += [f"{stems[1]}{'x' * (i % 40)}" for i in range(40)]
+    assert len(set(vocab)) == len(vocab) > 32768
+    data = vocab[::-1]
+    tokenizer = CategoryTokenizer()
+    tokenizer.fit(data)
+    assert list(tokenizer.categories) == sorted(vocab, key=str.encode)
+    queries = list(np.random.choice(vocab, 5000)) + ["shared/prefix", "日本語", ""]
+    assert list(tokenizer.encode(queries)) == [tokenizer.encode(value)[0] for value in queries]
+
 def benchmark():
     tokenizer = CategoryTokenizer()
     original_data = [
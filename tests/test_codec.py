@@ -0,0 +1,75 @@
+import numpy as np
+import pytest
+import time
+
+from zeichenformer import (
+    CategoryTokenizer,
+    NumericalTokenizer,
+    TimestampTokenizer,
+    compress_tokens,
+    decompress_tokens
+)
+from zeichenformer._tokenizers import compress_tokens as _compress_tokens
+
+def test_roundtrip():
+    categories = [f"cat_{i}" for i in range(20)]
+    category = CategoryTokenizer(offset=5)
+    category.fit(categories)
+    values = list(np.random.choice(categories, 5000))
+    tokens = category.encode(values)
+    assert np.array_equal(decompress_tokens(compress_tokens(tokens, 'category')), tokens)
+    sorted_tokens = np.sort(tokens)
+    compressed = compress_tokens(sorted_tokens, 'category')
+    assert len(compressed) < 200
+    assert np.array_equal(decompress_tokens(compressed), sorted_tokens)
+
+    numerical = NumericalTokenizer(num_bits=16, offset=100)
+    numerical.fit(np.random.uniform(-1.0, 1.0, 1000))
+    rows = numerical.encode(list(np.random.uniform(-1.0, 1.0, 1000)))
+    decoded = decompress_tokens(compress_tokens(rows, 'binary'))
+    assert len(decoded) == len(rows)
+    assert all(np.array_equal(a, b) for a, b in zip(decoded, rows))
+
+    timestamp = TimestampTokenizer(min_year=2020, max_year=2030)
+    stamps = timestamp.encode(["2025-01-15T10:30:00", "2025-06-01T23:59:59", "2026-12-31T00:00:00"])
+    compressed = compress_tokens(stamps, 'timestamp')
+    assert np.array_equal(decompress_tokens(compressed), np.vstack(stamps))
+
+    with pytest.raises(ValueError):
+        decompress_tokens(compressed[:-1])
+    with pytest.raises(ValueError):
+        compress_tokens(tokens, 'unknown')
+
+def test_misaligned_buffers():
+    # Trailing bytes that do not form a whole int32 must not be silently dropped
+    with pytest.raises(ValueError):
+        _compress_tokens(1, np.arange(4, dtype=np.int32).tobytes() + b"\x00")
+    with pytest.raises(ValueError):
+        _compress_tokens(2, np.arange(3, dtype=np.int32).tobytes(),
+                         np.array([3], dtype=np.uint32).tobytes() + b"\x00\x00")
+
+def test_packed_widths():
+    rng = np.random.default_rng(0)
+    for width in range(33):
+        high = (1 << width) - 1 if width < 32 else 2**31 - 1
+        for n in [7, 8, 9, 1025, 2049]:
+            tokens = rng.integers(0, high + 1, n, dtype=np.int64).astype(np.int32)
+            tokens[0] = high
+            assert np.array_equal(decompress_tokens(compress_tokens(tokens, 'category')), tokens)
+            stamps = rng.integers(0, high + 1, (n, 6), dtype=np.int64).astype(np.int32)
+            stamps[-1] = high
+            assert np.array_equal(decompress_tokens(compress_tokens(stamps, 'timestamp')), stamps)
+
+def benchmark():
+    tokens = np.random.randint(0, 50, 10_000_000).astype(np.int32)
+    compressed = compress_tokens(tokens, 'category')
+    print(f"Category ratio: {len(compressed) / tokens.nbytes:.3f}")
+
+    t0 = time.time()
+    decompress_tokens(compressed)
+    print(f"Decompress: {tokens.nbytes / (time.time() - t0) / 1e9:.2f} GB/s")
+
+if __name__ == "__main__":
+    test_roundtrip()
+    print("Tests passed!")
+    benchmark()
@@ -0,0 +1,97 @@
+import numpy as np
+import pytest
+import shutil
+import subprocess
+
+from zeichenformer import CategoryTokenizer, NumericalTokenizer, TimestampTokenizer, generate_header
+
+def test_generated_headers(tmp_path):
+    if shutil.which("g++") is None:
+        pytest.skip("g++ not available")
+
+    numerical = NumericalTokenizer(num_bits=12, offset=7)
+    data = np.random.uniform(-50.0, 50.0, 1000)
+    groups = np.random.randint(-3, 3, 1000)
+    numerical.fit(data, groups=groups)
+    values = [data.min(), data.max(), 0.0, 1e-9, -17.25, 1e6, float("nan")] + list(data[:20])
+    value_groups = [0, 1, -3, 2, 5, -1, 0] + list(groups[:20])
+
+    categories = ["apple", "banana", 'say "hi"', "back\\slash", "café", "日本"]
+    category = CategoryTokenizer(offset=4)
+    category.fit(categories)
+    queries = categories + ["durian", "", "app", "apple2"]
+    frequency = CategoryTokenizer(offset=1, order="frequency")
+    frequency.fit(categories + ["日本", "banana", "日本"])
+
+    timestamp = TimestampTokenizer(min_year=2000, max_year=2030, offset=3)
+    stamps = ["2025-01-15T10:30:00", "2000-12-31T23:59:60", "2025-01-15 10:30:00", "2025-01-15T10:30:05.75Z",
+              "2025-01-15T10:30:.5", "2031-01-01T00:00:00", "2025-13-01T00:00:00", "2025-1-5T1:2:3", "garbage"]
+
+    (tmp_path / "numerical.h").write_text(generate_header(numerical, "gen::numerical"))
+    (tmp_path / "category.h").write_text(generate_header(category, "gen::category"))
+    (tmp_path / "frequency.h").write_text(generate_header(frequency, "gen::frequency"))
+    (tmp_path / "timestamp.h").write_text(generate_header(timestamp, "gen::timestamp"))
+
+    def c_string(value):
+        return '"' + "".join(c if c.isascii() and c not in '"\\' else "".join(f"\\{b:03o}" for b in c.encode())
+                             for c in value) + '"'
+
+    program = f"""
+#include <cmath>
+#include <cstdio>
+#include "numerical.h"
+#include "category.h"
+#include "frequency.h"
+#include "timestamp.h"
+
+static_assert(gen::category::encode("banana") == 8, "folded at compile time");
+
+int main() {{
+    const double values[] = {{{", ".join(float(v).hex() if v == v else "NAN" for v in values)}}};
+    const long long groups[] = {{{", ".join(str(int(g)) for g in value_groups)}}};
+    const char* queries[] = {{{", ".join(c_string(q) for q in queries)}}};
+    const char* stamps[] = {{{", ".join(c_string(s) for s in stamps)}}};
+    int tokens[16];
+    for (double v : values) {{
+        int n = gen::numerical::encode(v, tokens);
+        for (int i = 0; i < n; i++) std::printf("%d ", tokens[i]);
+        std::printf("\\n");
+    }}
+    for (int r = 0; r < {len(values)}; r++) {{
+        int n = gen::numerical::encode_grouped(values[r], groups[r], tokens, r % 2 == 0);
+        for (int i = 0; i < n; i++) std::printf("%d ", tokens[i]);
+        std::printf("\\n");
+    }}
+    for (const char* q : queries) std::printf("%d\\n", gen::category::encode(q));
+    for (const char* q : queries) std::printf("%d\\n", gen::frequency::encode(q));
+    for (const char* s : stamps) {{
+        gen::timestamp::encode(s, tokens);
+        for (int i = 0; i < 6; i++) std::printf("%d ", tokens[i]);
+        std::printf("\\n");
+    }}
+}}
+"""
+    (tmp_path / "main.cpp").write_text(program)
+    subprocess.run(["g++", "-std=c++17", "-O2", "-Wall", "-Werror", "-o", str(tmp_path / "main"),
+                    str(tmp_path / "main.cpp")], check=True)
+    output = subprocess.run([str(tmp_path / "main")], check=True, capture_output=True, text=True).stdout.splitlines()
+
+    expected = [" ".join(map(str, row)) for row in numerical.encode(values)]
+    for r in range(len(values)):
+        row = numerical.encode([values[r]], groups=[value_groups[r]], fallback=r % 2 == 0)[0]
+        expected.append(" ".join(map(str, row)))
+    expected += [str(t) for t in category.encode(queries)]
+    expected += [str(t) for t in frequency.encode(queries)]
+    expected += [" ".join(map(str, row)) for row in timestamp.encode(stamps)]
+    assert [line.strip() for line in output] == expected
+
+    with pytest.raises(ValueError):
+        generate_header(CategoryTokenizer(), "gen")
+    with pytest.raises(ValueError):
+        generate_header(category, "not a namespace")
+
+if __name__ == "__main__":
+    import pathlib, tempfile
+    with tempfile.TemporaryDirectory() as directory:
+        test_generated_headers(pathlib.Path(directory))
+    print("Tests passed!")
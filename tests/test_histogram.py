@@ -0,0 +1,66 @@
+import numpy as np
+import pickle
+import threading
+import time
+
+from zeichenformer import CategoryTokenizer, NumericalTokenizer, TokenHistogram
+
+def test_drift():
+    categories = [f"cat_{i}" for i in range(50)]
+    tokenizer = CategoryTokenizer(offset=2)
+    tokenizer.fit(categories)
+    weights = np.random.dirichlet(np.ones(50))
+    reference = TokenHistogram.for_tokenizer(tokenizer)
+    reference.update(tokenizer.encode(list(np.random.choice(categories, 20_000, p=weights))))
+    tokens = tokenizer.encode(list(np.random.choice(categories, 20_000, p=weights)))
+    assert reference.counts[:2].sum() == 0 and reference.total == 20_000
+
+    live = TokenHistogram.for_tokenizer(tokenizer)
+    live.update(tokens)
+    assert np.array_equal(live.counts, np.bincount(tokens, minlength=live.num_tokens))
+    assert live.total == 20_000 and live.overflow == 0
+    assert live.psi(reference) < 0.05 and live.js(reference) < 0.01
+    assert reference.js(reference) == 0.0
+
+    shifted = TokenHistogram.for_tokenizer(tokenizer)
+    shifted.update(tokenizer.encode(list(np.random.choice(categories[:10], 20_000))))
+    assert shifted.psi(reference) > 1.0 and shifted.kl(reference) > 0.5
+    assert shifted.js(reference) <= np.log(2)
+
+    # Out-of-range tokens, saved references and concurrent writers
+    live.update(np.array([-1, live.num_tokens], dtype=np.int32))
+    assert live.overflow == 2
+    restored = pickle.loads(pickle.dumps(reference))
+    assert live.psi(restored) == live.psi(reference.counts) == live.psi(reference)
+    numerical = NumericalTokenizer(num_bits=8, offset=3)
+    data = np.random.uniform(0.0, 1.0, 1000)
+    numerical.fit(data)
+    histogram = TokenHistogram.for_tokenizer(numerical)
+    histogram.update(numerical.encode([data.max()]))
+    assert histogram.overflow == 0 and histogram.counts[3 + 8] == 1
+
+    live.reset()
+    threads = [threading.Thread(target=lambda: [live.update(tokens) for _ in range(10)]) for _ in range(4)]
+    for thread in threads:
+        thread.start()
+    for thread in threads:
+        thread.join()
+    assert live.total == 40 * len(tokens)
+
+def benchmark():
+    tokens = np.random.randint(0, 300, 10_000_000).astype(np.int32)
+    histogram = TokenHistogram(300)
+    histogram.update(tokens)
+
+    t0 = time.time()
+    histogram.update(tokens)
+    print(f"Update: {(time.time() - t0) / len(tokens) * 1e9:.2f} ns/token")
+
+    t0 = time.time()
+    np.bincount(tokens, minlength=300)
+    print(f"np.bincount: {(time.time() - t0) / len(tokens) * 1e9:.2f} ns/token")
+
+if __name__ == "__main__":
+    test_drift()
+    print("Tests passed!")
+    benchmark()
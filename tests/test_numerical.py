@@ -1,4 +1,5 @@
 import numpy as np
+import pickle
 import time
 
 from zeichenformer import NumericalTokenizer
@@ -17,6 +18,193 @@ def test_basic():
     decoded = tokenizer.decode(tokens)
     assert np.nansum(np.array(decoded) - values) < 1e-4
     
+def test_fit_chunks():
+    data = np.random.uniform(-5.0, 5.0, 10_000)
+    reference = NumericalTokenizer(num_bits=16)
+    reference.fit(data)
+    tokenizer = NumericalTokenizer(num_bits=16)
+    tokenizer.fit_chunks(np.array_split(data, 7))
+    values = [-4.9, -1.0, 0.0, 2.5, 4.9]
+    assert tokenizer.decode(tokenizer.encode(values)) == reference.decode(reference.encode(values))
+
+def test_dedup_encode():
+    tokenizer = NumericalTokenizer(num_bits=16)
+    tokenizer.fit([0.0, 5.0])
+    values = list(np.random.choice([0.5, 1.0, 2.5, 4.75, np.nan, 6.0], 5000))
+    reference = tokenizer.encode(values, dedup=False)
+    for dedup in (True, None):
+        tokens = tokenizer.encode(values, dedup=dedup)
+        assert all(np.array_equal(a, b) for a, b in zip(tokens, reference))
+
+def test_grouped_fit():
+    groups = np.random.randint(0, 3, 10_000)
+    scales = np.array([1.0, 1e3, 1e6])[groups]
+    data = np.random.uniform(0.0, 1.0, 10_000) * scales
+    tokenizer = NumericalTokenizer(num_bits=16)
+    tokenizer.fit(data, groups=groups)
+    assert tokenizer.num_groups == 3
+
+    values = data[:100]
+    decoded = np.array(tokenizer.decode(tokenizer.encode(list(values), groups=groups[:100]), groups=groups[:100]))
+    assert np.nanmax(np.abs(decoded - values) / scales[:100]) < 1e-4
+
+    # Unseen groups use the global range unless fallback is disabled
+    assert len(tokenizer.encode([5e5], groups=[7])[0]) > 0
+    assert len(tokenizer.encode([5e5], groups=[7], fallback=False)[0]) == 0
+
+def test_profile():
+    data = np.random.normal(3.0, 2.0, 100_000)
+    data[::100] = np.nan
+    data[5::1000] = 0.0
+    tokenizer = NumericalTokenizer(num_bits=16)
+    tokenizer.fit(data, profile=True)
+    profile = tokenizer.profile
+    values = data[~np.isnan(data)]
+    assert profile['count'] == len(values)
+    assert profile['nan_count'] == 1000 and profile['zero_count'] == 100
+    assert np.isclose(profile['mean'], values.mean()) and np.isclose(profile['variance'], values.var())
+    assert profile['histogram'].sum() + profile['zero_count'] == len(values)
+
+    chunked = NumericalTokenizer(num_bits=16)
+    chunked.fit_chunks(np.array_split(data, 7), profile=True)
+    assert np.isclose(chunked.profile['mean'], profile['mean'])
+    assert np.array_equal(chunked.profile['histogram'], profile['histogram'])
+
+    # The profile and group ranges survive pickling
+    groups = np.random.randint(0, 3, len(data))
+    tokenizer.fit(data, groups=groups, profile=True)
+    restored = pickle.loads(pickle.dumps(tokenizer))
+    assert restored.num_groups == 3 and restored.profile['mean'] == tokenizer.profile['mean']
+    assert np.array_equal(restored.encode([1.5], groups=[2])[0], tokenizer.encode([1.5], groups=[2])[0])
+
+    tokenizer.fit(data)
+    assert tokenizer.profile is None
+
+def test_embed():
+    data = np.random.normal(0.0, 1.0, 10_000)
+    tokenizer = NumericalTokenizer(num_bits=16, offset=3)
+    tokenizer.fit(data)
+    table = np.random.normal(size=(3 + 16 + 1, 32)).astype(np.float32)
+    values = np.concatenate([data[:500], [np.nan, 100.0]])
+    rows = tokenizer.encode(list(values))
+
+    pooled = tokenizer.embed(values, table)
+    assert np.allclose(pooled, np.stack([table[r].sum(axis=0) for r in rows]), atol=1e-5)
+    assert np.allclose(pooled[-2], table[3]) and not pooled[-1].any()    # missing token, out of range
+    pooled = tokenizer.embed(values, table, pooling='mean')
+    assert np.allclose(pooled[:-2], np.stack([table[r].mean(axis=0) for r in rows[:-2]]), atol=1e-5)
+
+def test_decode_probs():
+    data = np.random.uniform(-5.0, 20.0, 10_000)
+    groups = np.random.randint(0, 3, 10_000)
+    tokenizer = NumericalTokenizer(num_bits=10, offset=3)
+    tokenizer.fit(data, groups=groups)
+    rows = tokenizer.encode(list(data[:200]))
+    hard = np.zeros((200, 10), dtype=np.float32)
+    for i, row in enumerate(rows):
+        hard[i, row - 4] = 1.0
+
+    mean, var, best = tokenizer.decode_probs(hard, variance=True, map=True)
+    decoded = np.asarray(tokenizer.decode(rows))
+    active = np.array([len(row) > 0 for row in rows])    # decode() of no tokens is NaN
+    assert np.allclose(mean[active], decoded[active]) and np.allclose(best, mean) and not var.any()
+    grouped_rows = tokenizer.encode(list(data[:200]), groups=groups[:200])
+    grouped = np.zeros((200, 10), dtype=np.float32)
+    for i, row in enumerate(grouped_rows):
+        grouped[i, row - 4] = 1.0
+    active = np.array([len(row) > 0 for row in grouped_rows])
+    assert np.allclose(tokenizer.decode_probs(grouped, groups=groups[:200])[active],
+                       np.asarray(tokenizer.decode(grouped_rows, groups=groups[:200]))[active])
+    assert np.isnan(tokenizer.decode_probs(grouped[:1], groups=[7], fallback=False)).all()
+
+    # Soft probabilities against all 2^5 token sets of a small tokenizer
+    small = NumericalTokenizer(num_bits=5)
+    small.fit(data)
+    probs = np.random.uniform(0.0, 1.0, (4, 5)).astype(np.float32)
+    sets = [np.flatnonzero([(s >> b) & 1 for b in range(5)]) + 1 for s in range(32)]
+    values = np.asarray(small.decode(sets[1:]))
+    values = np.concatenate([small.decode_probs(np.zeros((1, 5))), values])
+    weights = np.array([[np.prod(np.where([(s >> b) & 1 for b in range(5)], p, 1 - p)) for s in range(32)]
+                        for p in probs.astype(np.float64)])
+    mean, var, best = small.decode_probs(probs, variance=True, map=True)
+    assert np.allclose(mean, weights @ values)
+    assert np.allclose(var, weights @ values ** 2 - (weights @ values) ** 2)
+    assert np.allclose(best, values[weights.argmax(axis=1)])
+
+def test_bins():
+    data = np.random.normal(0.0, 1.0, 10_001)
+    groups = np.random.randint(0, 4, 10_001)
+    tokenizer = NumericalTokenizer(num_bits=10, offset=3)
+    tokenizer.fit(data, groups=groups)
+    values = np.concatenate([data, [np.nan, 100.0]])
+    rows = tokenizer.encode(list(values))
+    bins = tokenizer.encode_bins(values)
+    expected = [3 + 2 + sum(1 << (10 - (t - 3)) for t in row) for row in rows]
+    assert bins.dtype == np.int32 and np.array_equal(bins[:-2], expected[:-2])
+    assert list(bins[-2:]) == [3, 4] and bins.max() < 3 + 2 + 2 ** 10
+
+    decoded = tokenizer.decode_bins(bins)
+    active = np.array([len(row) > 0 for row in rows]) & ~np.isnan(values)
+    assert np.allclose(decoded[active], np.asarray(tokenizer.decode(rows))[active])
+    assert np.isnan(decoded[-2:]).all()
+    assert np.array_equal(tokenizer.encode_bins(values[:9].reshape(3, 3)), bins[:9].reshape(3, 3))
+
+    grouped = tokenizer.encode_bins(data, groups=groups)
+    grouped_rows = tokenizer.encode(list(data), groups=groups)
+    assert np.array_equal(grouped, [3 + 2 + sum(1 << (10 - (t - 3)) for t in row) for row in grouped_rows])
+    assert tokenizer.encode_bins(data[:3], groups=[9, 9, 9], fallback=False).tolist() == [4, 4, 4]
+
+def test_missing():
+    data = np.random.uniform(0.0, 1.0, 1000)
+    tokenizer = NumericalTokenizer(num_bits=8, offset=3)
+    tokenizer.fit(data)
+    rows = tokenizer.encode([0.5, None, np.nan, np.float32("nan"), 0.25])
+    assert [list(r) for r in rows[1:4]] == [[3], [3], [3]]
+    assert np.isnan(tokenizer.decode(rows[1:4])).all() and not np.isnan(tokenizer.decode(rows[::4])).any()
+
+    mask = np.random.rand(300) < 0.8
+    mask[64:192] = True
+    values = list(data[:300])
+    rows = tokenizer.encode(values, validity=np.packbits(mask, bitorder='little'))
+    reference = tokenizer.encode(values)
+    assert all(list(r) == ([3] if not m else list(e)) for r, e, m in zip(rows, reference, mask))
+    groups = np.zeros(300, dtype=np.int64)
+    grouped = tokenizer.encode(values, groups=groups, validity=mask)
+    assert all(np.array_equal(a, b) for a, b in zip(grouped, rows))
+    bins = tokenizer.encode_bins(data[:300], validity=mask)
+    assert np.array_equal(bins, np.where(mask, tokenizer.encode_bins(data[:300]), 3))
+
+def test_reentrant_scratch():
+    # __float__ and __index__ may call back into the library while an outer call
+    # holds scratch buffers; the inner call must not release them
+    tokenizer = NumericalTokenizer(num_bits=8)
+    tokenizer.fit(np.linspace(0.0, 1.0, 100))
+
+    class Value:
+        def __float__(self):
+            tokenizer.encode([0.1] * 5000)
+            tokenizer.shrink_to_fit()
+            return 0.5
+
+    class Token:
+        def __init__(self, token):
+            self.token = int(token)
+
+        def __index__(self):
+            tokenizer.decode([[1, 2, 3]] * 3000)
+            tokenizer.shrink_to_fit()
+            return self.token
+
+    values = [0.25] * 2000 + [0.5] + [0.75] * 2000
+    expected = tokenizer.encode(values)
+    values[2000] = Value()
+    assert all(np.array_equal(a, b) for a, b in zip(tokenizer.encode(values), expected))
+
+    rows = [list(row) for row in expected[1995:2005]]
+    reference = tokenizer.decode(rows)
+    rows[5] = [Token(t) for t in rows[5]]
+    assert np.allclose(tokenizer.decode(rows), reference)
+
 def benchmark():
     tokenizer = NumericalTokenizer(num_bits=24)
     data = np.random.uniform(-1.0, 1.0, 1_000_000)
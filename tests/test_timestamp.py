@@ -1,5 +1,6 @@
 from zeichenformer import TimestampTokenizer
 
+import datetime
 import time
 import numpy as np
 
@@ -26,6 +27,77 @@ def test_basic():
     tokens = tokenizer.encode(incomplete)
     assert tokenizer.decode(tokens)[0] == "__invalid__"
 
+def test_lazy_decode():
+    tokenizer = TimestampTokenizer(min_year=2020, max_year=2030)
+    timestamps = ["2021-03-04T05:06:07", "2025-12-31T23:59:59", "2030-01-01T00:00:00"]
+    tokens = tokenizer.encode(timestamps)
+    view = tokenizer.decode(tokens, lazy=True)
+    assert len(view) == 3
+    assert view[1] == timestamps[1]
+    assert list(view[1:]) == timestamps[1:]
+    assert view.materialize() == tokenizer.decode(tokens)
+
+def test_dedup_encode():
+    tokenizer = TimestampTokenizer(min_year=2020, max_year=2030)
+    minutes = np.datetime64('2024-05-01T12:00') + np.random.randint(0, 50, 5000).astype('timedelta64[m]')
+    timestamps = [f"{m}:00" for m in minutes]
+    reference = tokenizer.encode(timestamps, dedup=False)
+    for dedup in (True, None):
+        tokens = tokenizer.encode(timestamps, dedup=dedup)
+        assert all(np.array_equal(a, b) for a, b in zip(tokens, reference))
+
+def test_decode_logits():
+    tokenizer = TimestampTokenizer(min_year=2000, max_year=2030, offset=2)
+    width = tokenizer.offset + tokenizer.num_bits + 1
+    stamps = ["2024-02-29T23:59:59", "2000-01-01T00:00:00", "2017-08-15T12:34:56"]
+    logits = np.random.normal(0.0, 0.1, (len(stamps), width)).astype(np.float32)
+    for row, tokens in zip(logits, tokenizer.encode(stamps)):
+        row[tokens] = 10.0
+    assert tokenizer.decode_logits(logits, output='string') == stamps
+    assert np.array_equal(tokenizer.decode_logits(logits), np.array(stamps, dtype='datetime64[s]'))
+    assert np.array_equal(tokenizer.decode_logits(logits, output='tokens'), np.vstack(tokenizer.encode(stamps)))
+
+    # Days are limited to the chosen month, so noise always decodes to real dates
+    noise = np.random.normal(size=(1000, width)).astype(np.float32)
+    decoded = tokenizer.decode_logits(noise, output='string')
+    assert np.array_equal(np.array(decoded, dtype='datetime64[s]'), tokenizer.decode_logits(noise))
+    assert tokenizer.decode_logits(noise, output='tokens', k=3).shape == (1000, 6, 3)
+
+def test_datetime_objects():
+    tokenizer = TimestampTokenizer(min_year=2000, max_year=2030, offset=5)
+    stamps = [datetime.datetime(2024, 2, 29, 23, 59, 58, 999999), datetime.date(2021, 5, 6),
+              datetime.datetime(2001, 1, 1, 0, 0, 1, tzinfo=datetime.timezone.utc), datetime.datetime(1999, 1, 1)]
+    strings = ["2024-02-29T23:59:58", "2021-05-06T00:00:00", "2001-01-01T00:00:01", "1999-01-01T00:00:00"]
+    tokens = tokenizer.encode(stamps)
+    reference = tokenizer.encode(strings)
+    assert all(np.array_equal(a, b) for a, b in zip(tokens, reference))
+    assert np.array_equal(tokenizer.encode(stamps[0]), reference[0])
+    mixed = tokenizer.encode([stamps[0], strings[1], stamps[2]])
+    assert all(np.array_equal(a, b) for a, b in zip(mixed, reference[:3]))
+
+    decoded = tokenizer.decode(tokens, output='datetime')
+    assert decoded[:3] == [datetime.datetime(2024, 2, 29, 23, 59, 58), datetime.datetime(2021, 5, 6),
+                           datetime.datetime(2001, 1, 1, 0, 0, 1)]
+    assert decoded[3] is None
+
+def test_embed():
+    tokenizer = TimestampTokenizer(min_year=2000, max_year=2030, offset=2)
+    table = np.random.normal(size=(tokenizer.offset + tokenizer.num_bits + 1, 4)).astype(np.float32)
+    values = [datetime.datetime(2024, 2, 29, 23, 59, 58), "2021-05-06T07:08:09", datetime.date(2021, 5, 6),
+              None, np.datetime64("NaT")]
+    pooled = tokenizer.embed(values, table)
+    assert pooled.shape == (5, 4)
+    for row, tokens in zip(pooled, tokenizer.encode(values)):
+        assert np.allclose(row, table[tokens].sum(axis=0))
+    assert np.array_equal(tokenizer.embed(values[0], table), pooled[0])
+    assert np.array_equal(tokenizer.embed(values[1], table, pooling='mean'),
+                          tokenizer.embed(values[1:2], table, pooling='mean')[0])
+    try:
+        tokenizer.embed([1.5], table)
+        assert False, "expected TypeError"
+    except TypeError:
+        pass
+
 def generate_timestamps():
     start_time = np.datetime64('2000-01-01T00:00:00')
     all_seconds = np.arange(10_000_000)
@@ -36,6 +108,21 @@ def generate_timestamps():
 
     return timestamps_iso
 
+def test_missing():
+    tokenizer = TimestampTokenizer(min_year=2000, max_year=2030, offset=4)
+    values = ["2021-03-04T05:06:07", None, np.datetime64("NaT"), float("nan"),
+              datetime.datetime(2022, 1, 2, 3, 4, 5), "garbage"]
+    tokens = tokenizer.encode(values)
+    assert all(list(row) == [4] * 6 for row in tokens[1:4])
+    assert tokenizer.decode(tokens) == ["2021-03-04T05:06:07", "__missing__", "__missing__", "__missing__",
+                                        "2022-01-02T03:04:05", "__invalid__"]
+    assert tokenizer.decode(tokens, output='datetime')[1] is None
+    assert list(tokenizer.encode(None)) == [4] * 6
+
+    mask = np.array([True, True, True, True, False, False])
+    masked = tokenizer.encode(values, validity=mask)
+    assert tokenizer.decode(masked)[4:] == ["__missing__", "__missing__"]
+
 def benchmark():
 
     timestamps = generate_timestamps()
@@ -1,7 +1,12 @@
 from .tokenizers import (
     NumericalTokenizer,
     CategoryTokenizer,
+    FrozenVocabulary,
     TimestampTokenizer
 )
+from .codec import compress_tokens, decompress_tokens
+from .histogram import TokenHistogram
+from .codegen import generate_header
 
-__all__ = ['NumericalTokenizer', 'CategoryTokenizer', 'TimestampTokenizer']
\ No newline at end of file
+__all__ = ['NumericalTokenizer', 'CategoryTokenizer', 'FrozenVocabulary', 'TimestampTokenizer',
+           'compress_tokens', 'decompress_tokens', 'TokenHistogram', 'generate_header']
\ No newline at end of file
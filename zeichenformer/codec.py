@@ -0,0 +1,70 @@
+import numpy as np
+from ._tokenizers import (
+    compress_tokens as _compress_tokens,
+    decompress_tokens as _decompress_tokens
+)
+
+_LAYOUTS = {'category': 1, 'binary': 2, 'timestamp': 3}
+
+
+def compress_tokens(tokens, layout: str) -> bytes:
+    """
+    Compresses the output of a tokenizer's encode() into a self-describing byte string.
+
+    Parameters:
+        tokens: Token stream in the shape the matching tokenizer produces:
+            - 'category': 1D int array, one token per row
+            - 'binary': list of 1D int arrays (one row per encoded value)
+            - 'timestamp': (n, 6) int array or list of length-6 arrays
+        layout (str): One of 'category', 'binary' or 'timestamp'
+
+    Returns:
+        bytes: Compressed stream, decoded by decompress_tokens()
+
+    Implementation Notes:
+        - Category: run-length coding of repeated tokens, or frame-of-reference
+          bit-packing when runs are short, whichever is smaller
+        - Binary: rows are stored as their lengths plus deltas between successive
+          (sorted) positions, in StreamVByte format
+        - Timestamp: each of the six components is bit-packed against its own
+          minimum, so e.g. a single year costs no bits at all
+        - StreamVByte decoding uses SSSE3 byte shuffles when the CPU supports them
+        - Bit-packed widths up to 25 unpack eight values at a time with AVX2
+          shuffles and per-lane shifts when the CPU supports them; wider values
+          and CPUs without AVX2 take the scalar load/shift path
+        - The stream is a plain byte string and can be embedded in any container
+    """
+    if layout not in _LAYOUTS:
+        raise ValueError(f"Unknown token layout: {layout!r}")
+    if layout == 'binary':
+        rows = [np.asarray(row, dtype=np.int32).ravel() for row in tokens]
+        counts = np.array([len(row) for row in rows], dtype=np.uint32)
+        flat = np.concatenate(rows) if rows else np.empty(0, dtype=np.int32)
+        return _compress_tokens(_LAYOUTS[layout], np.ascontiguousarray(flat), counts)
+    if layout == 'timestamp' and isinstance(tokens, (list, tuple)):
+        tokens = np.vstack(tokens) if tokens else np.empty((0, 6), dtype=np.int32)
+    flat = np.ascontiguousarray(tokens, dtype=np.int32).ravel()
+    return _compress_tokens(_LAYOUTS[layout], flat)
+
+
+def decompress_tokens(data):
+    """
+    Restores a token stream produced by compress_tokens().
+
+    Parameters:
+        data: bytes or any buffer (e.g. a memoryview of an mmap'd file)
+
+    Returns:
+        - 'category': 1D int32 array
+        - 'binary': list of 1D int32 arrays
+        - 'timestamp': (n, 6) int32 array
+
+    Raises:
+        ValueError: If the data is not a valid compressed token stream
+    """
+    layout, tokens, counts = _decompress_tokens(data)
+    if layout == _LAYOUTS['binary']:
+        return np.split(tokens, np.cumsum(counts, dtype=np.int64)[:-1]) if len(counts) else []
+    if layout == _LAYOUTS['timestamp']:
+        return tokens.reshape(-1, 6)
+    return tokens
@@ -0,0 +1,287 @@
+import math
+import re
+
+from .tokenizers import CategoryTokenizer, NumericalTokenizer, TimestampTokenizer
+
+_NAMESPACE = re.compile(r'^[A-Za-z_]\w*(::[A-Za-z_]\w*)*$')
+_INT64_MIN = -(1 << 63)
+
+
+def generate_header(tokenizer, namespace: str) -> str:
+    """
+    Compiles a fitted tokenizer into a self-contained C++17 header.
+
+    Parameters:
+        tokenizer: A fitted NumericalTokenizer, CategoryTokenizer or TimestampTokenizer
+        namespace (str): C++ namespace for the generated code (e.g. "features::price")
+
+    Returns:
+        str: Header source. It defines the fitted parameters as constexpr constants
+             and inline encode functions that return exactly the tokens of the
+             Python encode():
+             - Numerical: constexpr int encode(double value, int* tokens) returns the
+               number of tokens written; with group ranges also
+               encode_grouped(value, group, tokens, fallback=true)
+             - Category: constexpr int encode(std::string_view value) and
+               constexpr std::string_view decode(int token)
+             - Timestamp: void encode(const char* iso, int tokens[6])
+
+    Raises:
+        ValueError: If the tokenizer is not fitted or the namespace is not valid
+        TypeError: For other objects
+
+    Example:
+        >>> tokenizer = CategoryTokenizer()
+        >>> tokenizer.fit(["red", "green", "blue"])
+        >>> with open("colour.h", "w") as f:
+        ...     f.write(generate_header(tokenizer, "colour"))
+
+        // C++: static_assert(colour::encode("green") == 3);
+
+    Implementation Notes:
+        - No initialization code or I/O runs at startup; everything is a constant
+          the compiler can fold, and encode() calls on literals are compile-time
+        - Range bounds are written as hexadecimal float literals, so the
+          bisection reproduces the library bit for bit
+        - The vocabulary is a constexpr std::string_view array searched by
+          bisection, in the same byte order as the library (through an array of
+          sorted ids for a frequency-ordered tokenizer)
+        - Timestamps take a digit-only fast path for the canonical
+          YYYY-MM-DDTHH:MM:SS prefix and otherwise parse with the same sscanf
+          rules as the library
+    """
+    if not _NAMESPACE.match(namespace):
+        raise ValueError(f"Not a valid C++ namespace: {namespace!r}")
+    if isinstance(tokenizer, NumericalTokenizer):
+        body = _numerical(tokenizer)
+    elif isinstance(tokenizer, CategoryTokenizer):
+        body = _category(tokenizer)
+    elif isinstance(tokenizer, TimestampTokenizer):
+        body = _timestamp(tokenizer)
+    else:
+        raise TypeError(f"Cannot generate code for {type(tokenizer).__name__}")
+    includes, source = body
+    lines = [f"// Generated by zeichenformer.codegen from a fitted {type(tokenizer).__name__}; do not edit.",
+             "#pragma once",
+             ""]
+    lines += [f"#include <{name}>" for name in includes]
+    lines += ["", f"namespace {namespace} {{", "", source.strip("\n"), "", f"}}  // namespace {namespace}", ""]
+    return "\n".join(lines)
+
+
+def _cpp_double(value: float) -> str:
+    if math.isinf(value):
+        return ("-" if value < 0 else "") + "std::numeric_limits<double>::infinity()"
+    return float(value).hex()
+
+
+def _cpp_int64(value: int) -> str:
+    return "INT64_MIN" if value == _INT64_MIN else f"INT64_C({value})"
+
+
+def _cpp_string(value: str) -> str:
+    out = []
+    for byte in value.encode("utf-8"):
+        char = chr(byte)
+        if char in '"\\':
+            out.append("\\" + char)
+        elif 0x20 <= byte < 0x7f:
+            out.append(char)
+        else:
+            out.append(f"\\{byte:03o}")   # octal escapes stop after three digits
+    return '"' + "".join(out) + '"'
+
+
+def _numerical(tokenizer):
+    state = tokenizer._tokenizer.get_state()
+    if not state['fitted']:
+        raise ValueError("Tokenizer is not fitted")
+    source = f"""
+inline constexpr int kNumBits = {state['num_bits']};
+inline constexpr int kOffset = {state['offset']};
+inline constexpr double kMinVal = {_cpp_double(state['min_val'])};
+inline constexpr double kMaxVal = {_cpp_double(state['max_val'])};
+
+// Bisection tokens of value within [min_val, max_val]; returns the number written
+// to tokens (at most kNumBits, the missing token kOffset for NaN, none for values
+// outside the range)
+constexpr int encode_range(double value, double min_val, double max_val, int* tokens) {{
+    if (value != value) {{
+        tokens[0] = kOffset;
+        return 1;
+    }}
+    if (!(value >= min_val && value <= max_val)) return 0;
+    double center = (min_val + max_val) / 2.0;
+    double width = (max_val - min_val) / 2.0;
+    int count = 0;
+    for (int b = 0; b < kNumBits; b++) {{
+        if (value > center) {{
+            tokens[count++] = (b + 1) + kOffset;
+            center += width / 2.0;
+        }} else {{
+            center -= width / 2.0;
+        }}
+        width /= 2.0;
+    }}
+    return count;
+}}
+
+// Tokens of value against the fitted range
+constexpr int encode(double value, int* tokens) {{
+    return encode_range(value, kMinVal, kMaxVal, tokens);
+}}
+"""
+    if state['groups'] is not None and len(state['groups'][0]) > 0:
+        keys, mins, maxs = state['groups']
+        order = sorted(range(len(keys)), key=lambda i: int(keys[i]))
+        source += f"""
+inline constexpr std::size_t kNumGroups = {len(order)};
+// Group keys (sorted) and their fitted ranges
+inline constexpr std::int64_t kGroupKeys[kNumGroups] = {{{", ".join(_cpp_int64(int(keys[i])) for i in order)}}};
+inline constexpr double kGroupMin[kNumGroups] = {{{", ".join(_cpp_double(float(mins[i])) for i in order)}}};
+inline constexpr double kGroupMax[kNumGroups] = {{{", ".join(_cpp_double(float(maxs[i])) for i in order)}}};
+
+// Tokens of value against its group's range; groups not seen at fit use the
+// global range if fallback is set and encode to no tokens otherwise
+constexpr int encode_grouped(double value, std::int64_t group, int* tokens, bool fallback = true) {{
+    std::size_t low = 0, high = kNumGroups;
+    while (low < high) {{
+        std::size_t mid = low + (high - low) / 2;
+        if (kGroupKeys[mid] == group) return encode_range(value, kGroupMin[mid], kGroupMax[mid], tokens);
+        if (kGroupKeys[mid] < group) low = mid + 1;
+        else high = mid;
+    }}
+    return fallback || value != value ? encode(value, tokens) : 0;
+}}
+"""
+    return ["cstddef", "cstdint", "limits"], source
+
+
+def _category(tokenizer):
+    categories = tokenizer.categories
+    if not categories:
+        raise ValueError("Tokenizer is not fitted")
+    entries = "\n".join(f"    {_cpp_string(c)}," for c in categories)
+    order = sorted(range(len(categories)), key=lambda i: categories[i].encode("utf-8"))
+    source = f"""
+inline constexpr int kOffset = {tokenizer.offset};
+inline constexpr int kMissingToken = kOffset;   // empty value
+inline constexpr int kUnknownToken = 1;     // value not in the vocabulary
+inline constexpr std::size_t kNumCategories = {len(categories)};
+"""
+    if order == list(range(len(categories))):
+        source += f"""
+// Sorted by byte value; category i encodes to kOffset + 2 + i
+inline constexpr std::string_view kCategories[kNumCategories] = {{
+{entries}
+}};
+"""
+        key, token = "kCategories[mid]", "mid"
+    else:
+        source += f"""
+// In token order (by descending fit frequency); category i encodes to kOffset + 2 + i
+inline constexpr std::string_view kCategories[kNumCategories] = {{
+{entries}
+}};
+
+// Category ids sorted by byte value
+inline constexpr int kSortedIds[kNumCategories] = {{{", ".join(str(i) for i in order)}}};
+"""
+        key, token = "kCategories[kSortedIds[mid]]", "kSortedIds[mid]"
+    source += f"""
+// Token of a category
+constexpr int encode(std::string_view value) {{
+    if (value.empty()) return kMissingToken;
+    std::size_t low = 0, high = kNumCategories;
+    while (low < high) {{
+        std::size_t mid = low + (high - low) / 2;
+        int cmp = value.compare({key});
+        if (cmp == 0) return static_cast<int>({token}) + 2 + kOffset;
+        if (cmp < 0) high = mid;
+        else low = mid + 1;
+    }}
+    return kUnknownToken;
+}}
+
+// Category of a token, or the name of its sentinel
+constexpr std::string_view decode(int token) {{
+    if (token == kOffset) return "__missing__";
+    if (token == kOffset + 1) return "__unknown__";
+    if (token < kOffset + 2 || token >= kOffset + 2 + static_cast<int>(kNumCategories)) return "__invalid__";
+    return kCategories[token - (kOffset + 2)];
+}}
+"""
+    return ["cstddef", "string_view"], source
+
+
+def _timestamp(tokenizer):
+    offsets = tokenizer._tokenizer.bucket_offsets
+    source = f"""
+inline constexpr int kMinYear = {tokenizer.min_year};
+inline constexpr int kMaxYear = {tokenizer.max_year};
+inline constexpr int kOffset = {tokenizer.offset};
+// First token of the year, month, day, hour, minute and second components
+inline constexpr int kBucketOffsets[6] = {{{", ".join(str(o) for o in offsets)}}};
+inline constexpr int kNumTokens = {tokenizer.num_bits};
+
+namespace detail {{
+
+constexpr bool digits(const char* s, int n) {{
+    for (int i = 0; i < n; i++) {{
+        if (s[i] < '0' || s[i] > '9') return false;
+    }}
+    return true;
+}}
+
+constexpr int number(const char* s, int n) {{
+    int value = 0;
+    for (int i = 0; i < n; i++) value = value * 10 + (s[i] - '0');
+    return value;
+}}
+
+// Year, month, day, hour, minute and second of an ISO 8601 string
+inline bool parse(const char* iso, int* f) {{
+    if (iso == nullptr) return false;
+    if (digits(iso, 4) && iso[4] == '-' && digits(iso + 5, 2) && iso[7] == '-' && digits(iso + 8, 2) &&
+        iso[10] == 'T' && digits(iso + 11, 2) && iso[13] == ':' && digits(iso + 14, 2) && iso[16] == ':' &&
+        digits(iso + 17, 2)) {{
+        f[0] = number(iso, 4);
+        f[1] = number(iso + 5, 2);
+        f[2] = number(iso + 8, 2);
+        f[3] = number(iso + 11, 2);
+        f[4] = number(iso + 14, 2);
+        f[5] = number(iso + 17, 2);
+    }} else {{
+        const char* separator = std::strchr(iso, 'T');
+        if (separator == nullptr) separator = std::strchr(iso, ' ');
+        if (separator == nullptr || separator - iso != 10) return false;
+        if (std::sscanf(iso, "%4d-%2d-%2d", &f[0], &f[1], &f[2]) != 3) return false;
+        if (std::sscanf(separator + 1, "%2d:%2d:%2d", &f[3], &f[4], &f[5]) != 3) {{
+            float seconds;
+            if (std::sscanf(separator + 1, "%2d:%2d:%f", &f[3], &f[4], &seconds) != 3) return false;
+            f[5] = static_cast<int>(seconds);
+        }}
+    }}
+    return f[0] >= kMinYear && f[0] <= kMaxYear && f[1] >= 1 && f[1] <= 12 && f[2] >= 1 && f[2] <= 31 &&
+           f[3] >= 0 && f[3] <= 23 && f[4] >= 0 && f[4] <= 59 && f[5] >= 0 && f[5] <= 60;
+}}
+
+}}  // namespace detail
+
+// The six component tokens of a timestamp (each component's first token if invalid,
+// six missing tokens kOffset for nullptr)
+inline void encode(const char* iso, int tokens[6]) {{
+    if (iso == nullptr) {{
+        for (int i = 0; i < 6; i++) tokens[i] = kOffset;
+        return;
+    }}
+    int f[6];
+    if (!detail::parse(iso, f)) {{
+        for (int i = 0; i < 6; i++) tokens[i] = kBucketOffsets[i];
+        return;
+    }}
+    tokens[0] = (f[0] - kMinYear) + kBucketOffsets[0];
+    for (int i = 1; i < 6; i++) tokens[i] = f[i] + kBucketOffsets[i];
+}}
+"""
+    return ["cstdio", "cstring"], source
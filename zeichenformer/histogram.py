@@ -0,0 +1,132 @@
+import numpy as np
+from ._tokenizers import TokenHistogram as _TokenHistogram
+
+_PSI, _KL, _JS = 0, 1, 2
+
+
+class TokenHistogram:
+    """
+    Counts encoded tokens for drift monitoring, without decoding them.
+
+    Args:
+        num_tokens (int): Number of bins; tokens 0..num_tokens-1 are counted and
+                          anything else goes to `overflow`. Use for_tokenizer() to
+                          size it for a tokenizer's token space.
+
+    Example:
+        >>> tokenizer = CategoryTokenizer()
+        >>> tokenizer.fit(train_values)
+        >>> reference = TokenHistogram.for_tokenizer(tokenizer)
+        >>> reference.update(tokenizer.encode(train_values))
+        >>> live = TokenHistogram.for_tokenizer(tokenizer)
+        >>> live.update(tokenizer.encode(batch))
+        >>> live.psi(reference)
+        0.0031
+
+    Notes:
+    update() may be called from several threads at once. Each call counts its batch
+    into private per-thread counters and merges them into the shared counts with
+    atomic adds, so readers never block writers.
+    """
+    def __init__(self, num_tokens: int, counts=None):
+        self._histogram = _TokenHistogram(num_tokens, counts)
+
+    @classmethod
+    def for_tokenizer(cls, tokenizer) -> 'TokenHistogram':
+        """
+        Creates an empty histogram covering the tokens of a fitted tokenizer.
+
+        Implementation Notes:
+        - The histogram has offset + num_bits + 1 bins, enough for the largest
+          token of each tokenizer:
+          - NumericalTokenizer tokens top out at offset + num_bits
+          - CategoryTokenizer tokens top out at offset + num_bits - 1, so the
+            last bin stays empty
+          - TimestampTokenizer components stay below offset + num_bits, but a
+            leap second encodes to offset + num_bits, hence the extra bin
+        """
+        return cls(tokenizer.offset + tokenizer.num_bits + 1)
+
+    def update(self, tokens) -> None:
+        """
+        Counts a batch of tokens.
+
+        Parameters:
+            tokens: Output of any tokenizer's encode(): an int array of any shape
+                    or a list of int arrays (e.g. NumericalTokenizer rows).
+
+        Implementation Notes:
+        - Large batches are counted with the GIL released
+        - A batch covering the bins is counted into private arrays (four interleaved
+          ones for small token spaces, so runs of one token do not serialize on a
+          single counter) and flushed once per bin; smaller batches add directly
+        """
+        if isinstance(tokens, (list, tuple)):
+            tokens = np.concatenate([np.asarray(row, dtype=np.int32).ravel() for row in tokens]) \
+                if tokens else np.empty(0, dtype=np.int32)
+        self._histogram.update(tokens)
+
+    def reset(self) -> None:
+        """
+        Zeros all counts, e.g. at the start of a monitoring window.
+        """
+        self._histogram.reset()
+
+    def psi(self, reference, eps: float = 1e-6) -> float:
+        """
+        Population stability index of these counts against a reference.
+
+        Parameters:
+            reference: TokenHistogram or array of num_tokens counts
+            eps (float): Floor for the proportion of an empty bin
+
+        Returns:
+            float: sum((p - q) * ln(p / q)) over token proportions p (this) and
+                   q (reference); NaN if either histogram is empty
+        """
+        return self._histogram.divergence(self._reference(reference), _PSI, eps)
+
+    def kl(self, reference, eps: float = 1e-6) -> float:
+        """
+        Kullback-Leibler divergence KL(this || reference) in nats. Bins empty in the
+        reference are floored at proportion eps.
+        """
+        return self._histogram.divergence(self._reference(reference), _KL, eps)
+
+    def js(self, reference) -> float:
+        """
+        Jensen-Shannon divergence in nats (between 0 and ln 2); needs no smoothing.
+        """
+        return self._histogram.divergence(self._reference(reference), _JS)
+
+    def _reference(self, reference):
+        return reference._histogram if isinstance(reference, TokenHistogram) else reference
+
+    @property
+    def counts(self) -> np.ndarray:
+        """
+        Snapshot of the count per token (uint64).
+        """
+        return self._histogram.counts
+
+    @property
+    def total(self) -> int:
+        """
+        Number of counted tokens, excluding overflow.
+        """
+        return int(self._histogram.counts.sum())
+
+    @property
+    def overflow(self) -> int:
+        """
+        Number of tokens seen outside 0..num_tokens-1.
+        """
+        return self._histogram.overflow
+
+    @property
+    def num_tokens(self) -> int:
+        return self._histogram.num_tokens
+
+    def __reduce__(self):
+        counts = np.append(self._histogram.counts, np.uint64(self._histogram.overflow))
+        return (TokenHistogram, (self.num_tokens, counts))
@@ -2,6 +2,7 @@ import numpy as np
 from ._tokenizers import (
     BinaryTokenizer as _BinaryTokenizer,
     CategoryTokenizer as _CategoryTokenizer,
+    FrozenVocabulary as _FrozenVocabulary,
     TimestampTokenizer as _TimestampTokenizer
 )
 
@@ -35,7 +36,7 @@ class NumericalTokenizer:
         self._offset = offset
         self._tokenizer = _BinaryTokenizer(num_bits=num_bits, offset=offset)
 
-    def fit(self, data: np.ndarray) -> None:
+    def fit(self, data: np.ndarray, groups: np.ndarray = None, profile: bool = False) -> None:
         """
         Fits the tokenizer to the input data range.
 
@@ -43,17 +44,48 @@ class NumericalTokenizer:
             data : np.ndarray[float]
                 1D array of values used to determine the [min_val, max_val] range.
                 All future encodes will be relative to this range.
+            groups : np.ndarray[int] | None
+                Optional group key per value (e.g. currency or device type ids). Fits a
+                separate [min, max] range per group alongside the global range, so that
+                encode(..., groups=...) quantizes each row at its own group's scale.
+            profile : bool
+                Also gather the distribution summary exposed as `profile` (mean, variance,
+                NaN/zero counts, log histogram) in the same pass over the data.
 
         Implementation Notes:
         - Uses exact min/max from data (no epsilon padding)
         - NaN values are ignored during fitting
         - Empty input leaves tokenizer in unfitted state (encode/decode will return NaN)
+        - Grouped fitting aggregates chunks of the input on parallel threads into
+          per-thread hash tables, then merges them; refitting without groups drops
+          the group ranges
+        - Profiling computes moments per 256-value block (two vectorizable passes over
+          data in L1) and combines blocks and threads with Chan's parallel formula
         """
         if not isinstance(data, np.ndarray):
             data = np.array(data, dtype=np.float64)
-        self._tokenizer.fit(data)
+        self._tokenizer.fit(data, groups=groups, profile=profile)
 
-    def encode(self, values) -> list[np.ndarray]:
+    def fit_chunks(self, chunks, profile: bool = False) -> None:
+        """
+        Fits the tokenizer to a stream of data chunks of arbitrary total size.
+
+        Parameters:
+            chunks : Iterable[np.ndarray[float]]
+                Any iterable (e.g. a generator reading a file) yielding 1D arrays.
+                Only one chunk is held in memory at a time.
+            profile : bool
+                Also profile the stream; chunk profiles are merged exactly.
+
+        Implementation Notes:
+        - The [min_val, max_val] range is tracked exactly while streaming
+        - The result equals fit() on the concatenated chunks
+        - The tokenizer is only updated after the iterable is exhausted
+        """
+        self._tokenizer.fit_chunks(chunks, profile=profile)
+
+    def encode(self, values, dedup: bool = None, groups=None, fallback: bool = True,
+               validity=None) -> list[np.ndarray]:
         """
         Encodes numerical values into bit position sequences.
 
@@ -62,6 +94,20 @@ class NumericalTokenizer:
                 Input value(s) to encode. Can be:
                 - Single float -> returns 1D array
                 - Sequence of floats -> returns list of 1D arrays
+            dedup : bool | None
+                Encode each distinct value once and copy the result to its repeats.
+                None (default) decides per call from a HyperLogLog estimate of the
+                cardinality of a 4096-value sample; True/False force it on or off.
+            groups : int | Iterable[int] | None
+                Group key of each value; rows are encoded against their group's fitted
+                range (requires fit(..., groups=...)). Ignores dedup.
+            fallback : bool
+                For groups not seen at fit: encode against the global range (True) or
+                return empty arrays (False).
+            validity : buffer | np.ndarray[bool] | None
+                Marks missing rows, which encode to the missing token. Either an
+                Arrow-style bitmap (bit i % 8 of byte i // 8 set when row i is present,
+                e.g. a pyarrow validity buffer) or a boolean mask with one flag per row.
 
         Returns:
             np.ndarray[int32] | list[np.ndarray[int32]]
@@ -70,14 +116,17 @@ class NumericalTokenizer:
 
         Implementation Details:
         - Values outside fitted range return empty arrays
-        - NaN inputs return empty arrays
+        - NaN, None, pd.NA and rows marked missing encode to [offset], the missing
+          token (decode() gives NaN); the bitmap is scanned a 64-row word at a time
         - Each bisection level adds exactly 0 or 1 to the output sequence
+        - Deduplication pays off when values repeat on average 4+ times (ratings,
+          prices); runs of equal values in sorted input skip the hash table
         """
         
-        tokens = self._tokenizer.encode(values)
+        tokens = self._tokenizer.encode(values, dedup=dedup, groups=groups, fallback=fallback, validity=validity)
         return tokens
 
-    def decode(self, tokens) -> np.ndarray:
+    def decode(self, tokens, groups=None, fallback: bool = True) -> np.ndarray:
         """
         Reconstructs original values from token sequences.
 
@@ -86,6 +135,10 @@ class NumericalTokenizer:
                 Bit position sequences to decode. Can be:
                 - Single sequence -> returns float
                 - Multiple sequences -> returns array of floats
+            groups : Iterable[int] | None
+                Group key of each sequence, as passed to encode()
+            fallback : bool
+                Decode unseen groups against the global range (True) or as NaN (False)
 
         Returns:
             float | np.ndarray[float]
@@ -101,8 +154,126 @@ class NumericalTokenizer:
         - Else: move toward lower sub-interval
         3. Final position is the decoded value
         """
-        return self._tokenizer.decode(tokens)
+        return self._tokenizer.decode(tokens, groups=groups, fallback=fallback)
     
+    def encode_bins(self, values, groups=None, fallback: bool = True, validity=None) -> np.ndarray:
+        """
+        Encodes each value into a single token: the index of its quantization bin.
+
+        Parameters:
+            values: float array of any shape (or sequence of floats)
+            groups : Iterable[int] | None
+                Group key of each value, as in encode()
+            fallback : bool
+                For groups not seen at fit: use the global range (True) or the
+                out-of-range token (False)
+            validity : buffer | np.ndarray[bool] | None
+                Missing rows, as in encode()
+
+        Returns:
+            np.ndarray[int32]: One token per value, in the shape of values:
+            - offset for NaN and missing rows
+            - offset + 1 for values outside the fitted range (or without one)
+            - offset + 2 + bin otherwise, with 0 <= bin < 2^num_bits
+
+        Raises:
+            ValueError: If num_bits > 30 (the token space must fit an int32)
+
+        Implementation Notes:
+        - The bin index holds the same bisection bits encode() emits as tokens,
+          the first bit most significant, so bins and token sets map one to one
+        - Four values are bisected at once in float64 vector lanes with the exact
+          arithmetic of encode(); runs without the GIL
+        - Models need an embedding table of offset + 2 + 2^num_bits rows
+        """
+        return self._tokenizer.encode_bins(values, groups=groups, fallback=fallback, validity=validity)
+
+    def decode_bins(self, tokens, groups=None, fallback: bool = True) -> np.ndarray:
+        """
+        Inverse of encode_bins().
+
+        Parameters:
+            tokens: int array of bin tokens, any shape
+            groups, fallback: As passed to encode_bins()
+
+        Returns:
+            np.ndarray[float64]: The value decode() reconstructs from each bin's
+            token set, in the shape of tokens; NaN for the NaN and out-of-range
+            tokens and for ids outside the bin range
+        """
+        return self._tokenizer.decode_bins(tokens, groups=groups, fallback=fallback)
+
+    def decode_probs(self, probs: np.ndarray, groups=None, fallback: bool = True,
+                     variance: bool = False, map: bool = False):
+        """
+        Decodes per-bit probabilities, such as a model's sigmoid outputs, into values.
+
+        Parameters:
+            probs (np.ndarray): Array of shape (n, num_bits); probs[i, b] is the
+                                probability that token offset + b + 1 is active
+            groups : Iterable[int] | None
+                Group key of each row, as passed to encode()
+            fallback : bool
+                Decode unseen groups against the global range (True) or as NaN (False)
+            variance (bool): Also return the variance of the decoded value
+            map (bool): Also return the value of the most likely token set
+
+        Returns:
+            np.ndarray | tuple[np.ndarray, ...]
+                The expected value of each row, followed by the variance and/or the
+                MAP value if requested. Rows without a fitted range decode to NaN.
+
+        Implementation Notes:
+        - Bit b moves the value by +-(max - min) / 2^(b+2), so with independent bits
+          the mean and variance are exact weighted sums over the probabilities; no
+          sampling or enumeration of token sets
+        - The MAP value sets the bits with p > 0.5 and equals decode() of those tokens
+        - Four bits per step in float64 vector lanes; runs without the GIL
+        """
+        return self._tokenizer.decode_probs(probs, groups=groups, fallback=fallback, variance=variance, map=map)
+
+    def embed(self, values, table: np.ndarray, pooling: str = 'sum') -> np.ndarray:
+        """
+        Encodes values and pools the embedding rows of their tokens in one pass.
+
+        Equivalent to summing (or averaging) table[tokens] over each row of
+        encode(values), without building the token arrays.
+
+        Parameters:
+            values: 1D array or sequence of floats
+            table (np.ndarray): float32 embedding table of shape (rows, dim) with
+                                rows > offset + num_bits (row t embeds token t)
+            pooling (str): 'sum' or 'mean' (values encoding to no tokens, such as
+                           NaN or out-of-range values, pool to zeros)
+
+        Returns:
+            np.ndarray: float32 array of shape (len(values), dim)
+
+        Implementation Notes:
+        - Each active bit's row is accumulated the moment the bisection finds it,
+          with 8-lane float vector adds
+        - Runs without the GIL
+        """
+        return self._tokenizer.embed(values, table, pooling)
+
+    def memory_usage(self) -> dict:
+        """
+        Reports the bytes this tokenizer holds.
+
+        Returns:
+            dict: 'groups' (per-group range table), 'object' (the native object),
+                  'scratch' (the calling thread's temporary buffer arena, shared by
+                  all tokenizers used on that thread) and their 'total'
+        """
+        return self._tokenizer.memory_usage()
+
+    def shrink_to_fit(self) -> None:
+        """
+        Rehashes the group ranges into the smallest table that holds them and frees
+        the calling thread's scratch arena. fit() already compacts the group table.
+        """
+        self._tokenizer.shrink_to_fit()
+
     @property
     def offset(self) -> int:
         return self._offset
@@ -125,6 +296,39 @@ class NumericalTokenizer:
         """
         return self._tokenizer.max_active_features
 
+    @property
+    def profile(self) -> dict:
+        """
+        Distribution summary from the last fit with profile=True (None otherwise).
+
+        Keys:
+            count, nan_count, zero_count : int
+                Non-NaN values, NaNs and exact zeros
+            mean, variance, min, max : float
+                Moments (population variance) and range of the non-NaN values
+            histogram : np.ndarray[uint64]
+                128 log2 buckets: index 64 + k counts positives in [2^(k-32), 2^(k-31)),
+                index 63 - k the negatives of the same magnitude; the outermost buckets
+                also hold everything beyond them, and zeros are not bucketed
+        """
+        return self._tokenizer.profile
+
+    def __getstate__(self):
+        return {'offset': self._offset, 'tokenizer': self._tokenizer.get_state()}
+
+    def __setstate__(self, state):
+        tokenizer = state['tokenizer']
+        self._offset = state['offset']
+        self._tokenizer = _BinaryTokenizer(num_bits=tokenizer['num_bits'], offset=tokenizer['offset'])
+        self._tokenizer.set_state(tokenizer)
+
+    @property
+    def num_groups(self) -> int:
+        """
+        Number of per-group ranges from the last grouped fit (0 if fitted without groups).
+        """
+        return self._tokenizer.num_groups
+
 
 class CategoryTokenizer:
     """
@@ -137,12 +341,24 @@ class CategoryTokenizer:
     The token mapping is:
     0: "__missing__" (reserved for empty/NULL inputs)
     1: "__unknown__" (reserved for unseen categories)
-    2+: Actual categories (sorted alphabetically)
+    2+: Actual categories (sorted alphabetically, or by descending frequency)
 
     Args:
         categories (list[str], optional): Predefined categories. If provided,
                                         bypasses the need to call fit().
                                         Defaults to None.
+        bloom_fpr (float, optional): Target false positive rate of a blocked Bloom
+                                     filter built at fit time and checked before the
+                                     vocabulary search, so most unknown values are
+                                     rejected with one cache-line access. None (the
+                                     default) disables the filter.
+        order (str, optional): How fit assigns token ids. "sorted" (the default)
+                               numbers categories alphabetically. "frequency"
+                               numbers them by descending count in the fit data
+                               (ties alphabetically), so the most common categories
+                               occupy the first rows of an embedding table and stay
+                               cache resident; the hottest ones are also checked
+                               first when encoding.
 
     Example:
         >>> tokenizer = CategoryTokenizer()
@@ -152,9 +368,9 @@ class CategoryTokenizer:
         >>> tokenizer.decode([0, 1, 3])
         ["__missing__", "__unknown__", "banana"]
     """
-    def __init__(self, offset: int = 0):
+    def __init__(self, offset: int = 0, bloom_fpr: float = None, order: str = "sorted"):
         self._offset = offset
-        self._tokenizer = _CategoryTokenizer(offset=offset)
+        self._tokenizer = _CategoryTokenizer(offset=offset, bloom_fpr=bloom_fpr or 0.0, order=order)
 
     def fit(self, values: list[str]) -> None:
         """
@@ -171,13 +387,85 @@ class CategoryTokenizer:
         - Original strings are copied internally (safe to modify input after fitting)
 
         C-Level Behavior:
-        1. Deduplicates input while preserving original case
-        2. Uses qsort() with strcmp() for alphabetical ordering
-        3. Allocates independent memory for category strings
+        1. Deduplicates input with a hash table while preserving original case,
+           counting each category in the same pass
+        2. Sorts with a parallel multikey quicksort over cached 8-byte prefixes
+           (same order as strcmp(), so token ids match a qsort() build)
+        3. With order="frequency", numbers the categories by descending count and
+           keeps an id array in strcmp order for the search, plus SIMD scan keys of
+           the 32 most frequent categories that are checked first
+        4. Copies category strings into one contiguous arena
+        5. Vocabularies over 128 categories also get a search tree in Eytzinger
+           (BFS) order: 8-byte key prefixes descended without branches while
+           prefetching three levels ahead, with a permutation back to token ids.
+           Only equal prefixes need a full string comparison
         """
         self._tokenizer.fit(values)
 
-    def encode(self, values) -> list[np.ndarray]:
+    def fit_chunks(self, chunks, sample_size: int = None, seed: int = 0) -> None:
+        """
+        Builds the category vocabulary from a stream of chunks of arbitrary total size.
+
+        Parameters:
+            chunks : Iterable[Sequence[str]]
+                Any iterable (e.g. a generator reading a file) yielding sequences
+                of strings. Only one chunk is held in memory at a time.
+            sample_size : int, optional
+                If None (default), the vocabulary is exact: the same as fit() on the
+                concatenated chunks, using memory proportional to the number of
+                unique values. Otherwise, the vocabulary is built from a uniform
+                reservoir sample of `sample_size` rows, so memory stays constant
+                regardless of the stream length and cardinality.
+            seed : int
+                Seed of the reservoir sampler.
+        """
+        self._tokenizer.fit_chunks(chunks, sample_size=sample_size or 0, seed=seed)
+
+    def partial_fit(self, values: list[str]) -> bytes:
+        """
+        Builds a serialized partial fit state without modifying the tokenizer.
+
+        Parameters:
+            values : list[str]
+                One partition of the raw category strings.
+
+        Returns:
+            bytes
+                Sorted unique keys with occurrence counts, front coded so that
+                shared prefixes are stored once. States from many partitions are
+                combined with merge_partials() or fit_partials().
+        """
+        return self._tokenizer.partial_fit(values)
+
+    def merge_partials(self, states: list[bytes]) -> bytes:
+        """
+        Combines partial fit states into a single partial fit state.
+
+        Parameters:
+            states : list[bytes]
+                States produced by partial_fit() or merge_partials().
+
+        Returns:
+            bytes
+                The merged state, so reductions can be done hierarchically.
+
+        Implementation Notes:
+        - K-way heap merge of the sorted keys, O(U log k) for U total unique keys
+        - Counts of keys present in several states are summed
+        - Malformed or unsorted states → ValueError
+        """
+        return self._tokenizer.merge_partials(states)
+
+    def fit_partials(self, states: list[bytes]) -> None:
+        """
+        Fits the vocabulary from partial fit states.
+
+        The result is identical to calling fit() on the concatenation of all
+        partitions the states were built from.
+        """
+        self._tokenizer.fit_partials(states)
+
+    def encode(self, values, validity=None) -> list[np.ndarray]:
         """
         Converts category strings to integer tokens.
 
@@ -186,6 +474,10 @@ class CategoryTokenizer:
                 Input(s) to encode. Can be:
                 - Single string -> returns scalar array
                 - Sequence of strings -> returns 1D array
+            validity : buffer | np.ndarray[bool] | None
+                Marks missing rows, which encode to the missing token. Either an
+                Arrow-style bitmap (bit i % 8 of byte i // 8 set when row i is present,
+                e.g. a pyarrow validity buffer) or a boolean mask with one flag per row.
 
         Returns:
             np.ndarray[int32]
@@ -195,14 +487,23 @@ class CategoryTokenizer:
                 - ≥2 = Valid category (offset by 2)
 
         Special Cases:
-        - None/empty string → 0 ("__missing__")
+        - None, NaN, pd.NA, empty strings and rows marked missing → offset ("__missing__")
         - Unseen category → 1 ("__unknown__")
-        - Non-string input → TypeError
+        - Other non-string input → TypeError
+
+        Implementation Notes:
+        - A direct-mapped cache keyed on the address of each str object, scoped to
+          the call, lets repeated objects (as pandas and pyarrow object columns
+          produce) resolve with one pointer compare; only distinct objects are
+          looked up in the vocabulary
+        - Probing stops after 4096 rows if fewer than 1/8 of them hit the cache
+        - For vocabularies over 128 categories, the tree searches of 16 rows run in
+          lockstep with software prefetching, overlapping their cache misses
         """
-        tokens = self._tokenizer.encode(values)
+        tokens = self._tokenizer.encode(values, validity=validity)
         return tokens
 
-    def decode(self, tokens) -> list[str]:
+    def decode(self, tokens, lazy: bool = False) -> list[str]:
         """
         Converts tokens back to original category strings.
 
@@ -211,9 +512,13 @@ class CategoryTokenizer:
                 Token(s) to decode. Can be:
                 - Single int -> returns single string
                 - Sequence -> returns list of strings
+            lazy : bool
+                Return a DecodedView instead of a list. The view holds the tokens as an
+                int32 array and decodes an element only when it is indexed or sliced;
+                view.materialize() decodes everything into a list.
 
         Returns:
-            list[str]
+            list[str] | DecodedView
                 Decoded strings with special cases:
                 - 0 → "__missing__"
                 - 1 → "__unknown__"
@@ -222,13 +527,128 @@ class CategoryTokenizer:
         Error Handling:
         - Returns placeholder strings for invalid tokens rather than raising
         - Non-integer inputs → TypeError
+
+        Implementation Notes:
+        - A view decodes against the tokenizer's vocabulary at access time, so refitting
+          the tokenizer changes what an existing view returns
+        - materialize() builds each distinct category string once and shares it
+        """
+        return self._tokenizer.decode(tokens, lazy=lazy)
+
+    def freeze(self) -> bytes:
+        """
+        Compiles the fitted vocabulary into an immutable, encode-only artifact.
+
+        Returns:
+            bytes
+                A minimal perfect hash over the categories (about 6.4 bits per key)
+                followed by one 8-byte entry per key (32-bit fingerprint + token id).
+                The layout holds no pointers, so it can be written to a file and
+                loaded with FrozenVocabulary(mmap.mmap(...)).
+
+        Implementation Notes:
+        - Encoding costs one hash plus two memory accesses
+        - Token ids match encode() on this tokenizer
+        - Decoding is not supported by the artifact (strings are not stored)
+        """
+        return self._tokenizer.freeze()
+
+    def decode_logits(self, logits: np.ndarray, output: str = 'string', k: int = 1):
+        """
+        Decodes a model's logits over the token space without a numpy argmax pass.
+
+        Parameters:
+            logits (np.ndarray): float32 array of shape (n, vocab) with
+                                 vocab >= offset + num_bits (column t scores token t)
+            output (str): 'string' for category strings or 'tokens' for token ids
+            k (int): Number of candidates per row, best first
+
+        Returns:
+            - k == 1: list of n strings, or an int32 array of shape (n,)
+            - k > 1: list of n lists of k strings, or an int32 array of shape (n, k)
+
+        Implementation Notes:
+        - Only the category segment [offset + 2, offset + num_bits) is searched, so
+          the missing/unknown sentinels are never predicted
+        - The argmax takes an 8-lane vector maximum, then finds its first position
+          (ties go to the lower token, as in np.argmax); NaN logits never win
+        - Runs without the GIL; strings are created once per distinct category
+        """
+        return self._tokenizer.decode_logits(logits, output, k)
+
+    def embed(self, values: list[str], table: np.ndarray, pooling: str = 'sum') -> np.ndarray:
+        """
+        Encodes categories straight into their embedding rows.
+
+        Parameters:
+            values (list[str]): Category strings
+            table (np.ndarray): float32 embedding table of shape (rows, dim) with
+                                rows >= offset + num_bits (row t embeds token t)
+            pooling (str): 'sum' or 'mean'; identical here, as every value has one token
+
+        Returns:
+            np.ndarray: float32 array of shape (len(values), dim); table[encode(v)],
+                        so missing values (None, NaN, empty strings) embed as table[offset]
+        """
+        return self._tokenizer.embed(values, table, pooling)
+
+    def memory_usage(self) -> dict:
         """
-        return self._tokenizer.decode(tokens)
+        Reports the bytes this tokenizer holds, by structure.
+
+        Returns:
+            dict with keys:
+                - 'strings': category string arena
+                - 'index': sorted category pointers (8 bytes per category), the
+                  frequency-ordered token ids when order="frequency" (4 bytes per
+                  category), the SIMD scan keys of small vocabularies, and the
+                  Eytzinger search tree of 8-byte prefixes plus 4-byte ids,
+                  (n + 1) * 12 bytes for n categories
+                - 'filter': unknown-category Bloom filter (0 unless bloom_fpr is set)
+                - 'object': the native object itself
+                - 'scratch': the calling thread's temporary buffer arena, shared by
+                  all tokenizers used on that thread
+                - 'total': sum of the above
+
+        Implementation Notes:
+        - Values are allocation sizes, so unused capacity is included
+        """
+        return self._tokenizer.memory_usage()
+
+    def shrink_to_fit(self) -> None:
+        """
+        Releases unused capacity: the string arena is reallocated to its exact size
+        and the calling thread's scratch arena is freed (it is regrown on demand).
+        fit() already compacts the arena, so this mainly returns scratch memory
+        after encoding very large batches.
+        """
+        self._tokenizer.shrink_to_fit()
 
     @property
     def offset(self) -> int:
         return self._offset
     
+    @property
+    def bloom_fpr(self) -> float:
+        """
+        Target false positive rate of the unknown-category filter (0.0 = disabled).
+        """
+        return self._tokenizer.bloom_fpr
+
+    @property
+    def order(self) -> str:
+        """
+        How fit assigns token ids: "sorted" or "frequency".
+        """
+        return self._tokenizer.order
+
+    @property
+    def categories(self) -> tuple:
+        """
+        Fitted categories in token order: categories[i] encodes to offset + 2 + i.
+        """
+        return self._tokenizer.categories
+
     @property
     def num_categories(self) -> int:
         """
@@ -255,6 +675,53 @@ class CategoryTokenizer:
         return 3
 
 
+class FrozenVocabulary:
+    """
+    Serving-time view over an artifact produced by CategoryTokenizer.freeze().
+
+    Args:
+        buffer (bytes-like): The artifact, e.g. bytes or an mmap of a file written
+                             from freeze(). The buffer is referenced, not copied.
+
+    Example:
+        >>> tokenizer = CategoryTokenizer()
+        >>> tokenizer.fit(["apple", "banana", "cherry"])
+        >>> frozen = FrozenVocabulary(tokenizer.freeze())
+        >>> frozen.encode(["banana", "durian"])
+        array([3, 1], dtype=int32)
+
+    Notes:
+    An unknown value whose 32-bit fingerprint collides with the key stored in its
+    slot is reported as that key (probability 2^-32 per unknown value).
+    """
+    def __init__(self, buffer):
+        self._vocabulary = _FrozenVocabulary(buffer)
+
+    def encode(self, values, validity=None) -> np.ndarray:
+        """
+        Converts category strings to integer tokens (same ids as the source tokenizer).
+
+        Parameters:
+            values : str | Iterable[str]
+                Input(s) to encode, as in CategoryTokenizer.encode()
+            validity : buffer | np.ndarray[bool] | None
+                Arrow-style bitmap or boolean mask of present rows; missing rows,
+                None, NaN, pd.NA and empty strings encode to the missing token offset
+        """
+        return self._vocabulary.encode(values, validity=validity)
+
+    @property
+    def num_categories(self) -> int:
+        return self._vocabulary.num_categories
+
+    @property
+    def nbytes(self) -> int:
+        """
+        Size of the artifact in bytes.
+        """
+        return self._vocabulary.nbytes
+
+
 class TimestampTokenizer:
     """
     Tokenizes ISO 8601 timestamps into discrete components with validation.
@@ -298,16 +765,24 @@ class TimestampTokenizer:
         self._offset = offset
         self._tokenizer = _TimestampTokenizer(min_year=min_year, max_year=max_year, offset=offset)
 
-    def encode(self, values) -> list[np.ndarray]:
+    def encode(self, values, dedup: bool = None, validity=None) -> list[np.ndarray]:
         """
         Converts ISO 8601 timestamps to component tokens.
 
         Parameters:
-            timestamps : str | Iterable[str]
-                Input timestamp(s) in "YYYY-MM-DDTHH:MM:SS" format.
-                Can be:
-                - Single string -> returns (6,) array
+            timestamps : str | datetime | Iterable[str | datetime]
+                Input timestamp(s) in "YYYY-MM-DDTHH:MM:SS" format, or datetime.datetime /
+                datetime.date objects (including pandas Timestamps). Can be:
+                - Single value -> returns (6,) array
                 - Sequence -> returns list of (6,) arrays
+            dedup : bool | None
+                Parse each distinct string once and copy its tokens to the repeats.
+                None (default) enables it when a sampled cardinality estimate shows
+                heavy repetition (e.g. minute-resolution columns); True/False force it.
+            validity : buffer | np.ndarray[bool] | None
+                Marks missing rows, which encode to the missing token. Either an
+                Arrow-style bitmap (bit i % 8 of byte i // 8 set when row i is present,
+                e.g. a pyarrow validity buffer) or a boolean mask with one flag per row.
 
         Returns:
             np.ndarray[int32] | list[np.ndarray[int32]]
@@ -315,36 +790,118 @@ class TimestampTokenizer:
                 - Valid components: Mapped to token ranges shown above
                 - Invalid components: Flagged with boundary values
                 - Malformed input: All components marked invalid
+                - Missing input (None, NaN, NaT, pd.NaT, pd.NA or marked missing):
+                  six missing tokens, [offset] * 6, decoded as "__missing__"
 
         Example:
             >>> tokenizer.encode("2025-02-30T25:61:61")  # Invalid date/time
             array([7, 5, 46, 70, 130, 190], dtype=int32)  # Day/hour/minute/second invalid
+
+        Implementation Notes:
+        - datetime objects are encoded from their fields (PyDateTime_GET_* macros)
+          without formatting and re-parsing an ISO string; dates encode as midnight
+        - Like strings, their local fields are used as is: time zones are ignored
+          and microseconds are truncated
         """
-        tokens = self._tokenizer.encode(values)
+        tokens = self._tokenizer.encode(values, dedup=dedup, validity=validity)
         return tokens
 
-    def decode(self, tokens) -> list[str]:
+    def decode(self, tokens, lazy: bool = False, output: str = 'string') -> list[str]:
         """
         Reconstructs timestamps from component tokens.
 
         Parameters:
             tokens : array-like | Iterable[array-like]
                 Token sequence(s) to decode. Each must contain exactly 6 tokens.
+            lazy : bool
+                Return a DecodedView over the tokens as an (n, 6) int32 array that formats
+                a timestamp only when it is indexed or sliced. view.materialize()
+                decodes everything into a list.
+            output : str
+                'string' for ISO 8601 strings, or 'datetime' for datetime.datetime
+                objects built directly from the components (None for token rows that
+                are not a real date and time, including leap seconds). Not lazy.
 
         Returns:
-            list[str]
+            list[str] | DecodedView
                 Reconstructed timestamps in ISO format. Invalid components return:
-                - "__invalid__" for malformed token sequences.
-                - Clamped values for out-of-bounds years
-                - Best-effort reconstruction for other invalid components
+                - "__missing__" for the missing row
+                - "__invalid__" for malformed token sequences and rows with a
+                  component out of range (including unparsable input)
 
         Example:
             >>> tokens = tokenizer.encode("2025-02-30T25:61:61") # Invalid date/time
             >>> tokenizer.decode(tokens)  # [[7, 5, 46, 70, 130, 190],]
             ["__invalid__"]
         """
-        return self._tokenizer.decode(tokens)
+        return self._tokenizer.decode(tokens, lazy=lazy, output=output)
     
+    def decode_logits(self, logits: np.ndarray, output: str = 'datetime64', k: int = 1):
+        """
+        Decodes a model's logits over the token space into timestamps.
+
+        Each component (year, month, day, hour, minute, second) takes the argmax of
+        its own segment of the row, as given by the tokenizer's bucket offsets.
+
+        Parameters:
+            logits (np.ndarray): float32 array of shape (n, vocab) whose column t
+                                 scores token t; vocab must cover the last second token
+            output (str):
+                - 'datetime64': np.ndarray of datetime64[s]
+                - 'string': list of ISO 8601 strings, as decode()
+                - 'tokens': int32 array of shape (n, 6), or (n, 6, k) for k > 1
+            k (int): Candidates per component, best first (only with output='tokens';
+                     -1 pads segments with fewer than k tokens)
+
+        Implementation Notes:
+        - Only valid values compete: months 1-12, hours 0-23, seconds 0-59, and days
+          up to the length of the chosen month (leap years included), so every
+          decoded timestamp is a real date
+        - Runs without the GIL, with an 8-lane vector argmax per segment
+        """
+        return self._tokenizer.decode_logits(logits, output, k)
+
+    def embed(self, values, table: np.ndarray, pooling: str = 'sum') -> np.ndarray:
+        """
+        Encodes timestamps and pools the embedding rows of their six tokens in one pass.
+
+        Parameters:
+            values: ISO 8601 string, datetime.datetime / datetime.date, or a sequence
+                    of them; missing values (None, NaN, NaT) embed their missing tokens,
+                    and datetimes are read from their fields as in encode()
+            table (np.ndarray): float32 embedding table of shape (rows, dim) with
+                                rows > offset + num_bits (a leap second encodes to
+                                offset + num_bits)
+            pooling (str): 'sum' or 'mean' of the six component rows
+
+        Returns:
+            np.ndarray: float32 array of shape (len(values), dim), or (dim,) for a
+                        single value
+        """
+        return self._tokenizer.embed(values, table, pooling)
+
+    def memory_usage(self) -> dict:
+        """
+        Reports the bytes this tokenizer holds: 'object' (the native object, which
+        has no heap allocations), 'scratch' (the calling thread's temporary buffer
+        arena) and their 'total'.
+        """
+        return self._tokenizer.memory_usage()
+
+    def shrink_to_fit(self) -> None:
+        """
+        Frees the calling thread's scratch arena.
+        """
+        self._tokenizer.shrink_to_fit()
+
+    @property
+    def min_year(self) -> int:
+        return self._tokenizer.min_year
+
+    @property
+    def max_year(self) -> int:
+        return self._tokenizer.max_year
+
     @property
     def offset(self) -> int:
         return self._offset